@@ -20,6 +20,11 @@ typedef float Real;
 
 const Real g_degToRad = (Real)M_PI / 180.f;
 
+#include <Common/Rotation.h>
 #include <Common/Vector4.h>
+#include <Common/Vec2x4.h>
 #include <Common/Transform.h>
 #include <Common/Matrix.h>
+#include <Common/Matrix22.h>
+#include <Common/SparseMatrix.h>
+#include <Common/SparseLdlt.h>
@@ -0,0 +1,86 @@
+#include <Common/CpuFeatures.h>
+
+#include <intrin.h>
+
+namespace CpuFeatures
+{
+	// Feature bits of cpuid leaves 1 and 7
+	static const int ECX1_SSE41 = 1 << 19;
+	static const int ECX1_FMA = 1 << 12;
+	static const int ECX1_OSXSAVE = 1 << 27;
+	static const int ECX1_AVX = 1 << 28;
+	static const unsigned int EBX7_AVX2 = 1u << 5;
+	static const unsigned int EBX7_AVX512F = 1u << 16;
+	static const unsigned int EBX7_AVX512DQ = 1u << 17;
+	static const unsigned int EBX7_AVX512BW = 1u << 30;
+	static const unsigned int EBX7_AVX512VL = 1u << 31;
+
+	// Compilers targeting AVX-512 may emit any of these, not only foundation instructions
+	static const unsigned int EBX7_AVX512 = EBX7_AVX512F | EBX7_AVX512DQ | EBX7_AVX512BW | EBX7_AVX512VL;
+
+	// Register state the OS saves on context switches, from XCR0
+	static const unsigned long long XCR0_YMM = 0x6;  // SSE and AVX state
+	static const unsigned long long XCR0_ZMM = 0xe6; // Plus opmask and both halves of zmm state
+
+	static SimdLevel detectSimdLevel()
+	{
+		int regs[4]; // eax, ebx, ecx, edx
+
+		__cpuid( regs, 0 );
+		const int maxLeaf = regs[0];
+
+		__cpuid( regs, 1 );
+		const int ecx1 = regs[2];
+
+		if ( ( ecx1 & ECX1_SSE41 ) == 0 )
+		{
+			return SimdLevel::SCALAR;
+		}
+
+		// Wider registers are only usable if the OS preserves them
+		if ( ( ecx1 & ECX1_OSXSAVE ) == 0 || ( ecx1 & ECX1_AVX ) == 0 || ( ecx1 & ECX1_FMA ) == 0 || maxLeaf < 7 )
+		{
+			return SimdLevel::SSE41;
+		}
+
+		const unsigned long long xcr0 = _xgetbv( 0 );
+
+		__cpuidex( regs, 7, 0 );
+		const unsigned int ebx7 = ( unsigned int )regs[1];
+
+		if ( ( xcr0 & XCR0_YMM ) != XCR0_YMM || ( ebx7 & EBX7_AVX2 ) == 0 )
+		{
+			return SimdLevel::SSE41;
+		}
+
+		if ( ( xcr0 & XCR0_ZMM ) != XCR0_ZMM || ( ebx7 & EBX7_AVX512 ) != EBX7_AVX512 )
+		{
+			return SimdLevel::AVX2;
+		}
+
+		return SimdLevel::AVX512;
+	}
+
+	SimdLevel getSupportedSimdLevel()
+	{
+		static const SimdLevel level = detectSimdLevel();
+		return level;
+	}
+
+	const char* getSimdLevelName( SimdLevel level )
+	{
+		switch ( level )
+		{
+		case SimdLevel::SCALAR:
+			return "Scalar";
+		case SimdLevel::SSE41:
+			return "SSE4.1";
+		case SimdLevel::AVX2:
+			return "AVX2";
+		case SimdLevel::AVX512:
+			return "AVX-512";
+		default:
+			return "Unknown";
+		}
+	}
+}
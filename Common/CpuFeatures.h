@@ -0,0 +1,19 @@
+#pragma once
+
+namespace CpuFeatures
+{
+	// Instruction sets with their own kernel variants, each level includes the ones before it
+	enum class SimdLevel
+	{
+		SCALAR = 0,
+		SSE41,
+		AVX2,   // With FMA
+		AVX512, // F, DQ, BW and VL
+		NUM_LEVELS
+	};
+
+	// Highest level supported by both CPU and OS, detected on first call
+	SimdLevel getSupportedSimdLevel();
+
+	const char* getSimdLevelName( SimdLevel level );
+}
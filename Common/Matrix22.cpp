@@ -0,0 +1,13 @@
+#include <Common/Base.h>
+
+//
+// Matrix22 class non-inline functions
+Matrix22::Matrix22()
+{
+	setZero();
+}
+
+Matrix22::Matrix22( const Real m00, const Real m01, const Real m10, const Real m11 )
+{
+	set( m00, m01, m10, m11 );
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+class Vector4;
+
+// Fixed size 2x2 matrix kept by value, for small dense solves where Matrix would allocate
+class Matrix22
+{
+public:
+
+	Matrix22();
+	Matrix22( const Real m00, const Real m01, const Real m10, const Real m11 );
+
+	inline Real& operator()( int row, int col );
+	inline const Real& operator()( int row, int col ) const;
+
+	inline void set( const Real m00, const Real m01, const Real m10, const Real m11 );
+	inline void setZero();
+	inline void setIdentity();
+
+	inline Real getDeterminant() const;
+
+	// Set into inverse of m, left zeroed and returns false when m is singular
+	inline bool setInverse( const Matrix22& m );
+
+	// Product with x and y of v, z and w of result are zero
+	inline Vector4 mul( const Vector4& v ) const;
+
+private:
+
+	Real m_data[4]; // Row major
+};
+
+#include <Common/Matrix22.inl>
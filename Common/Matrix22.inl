@@ -0,0 +1,56 @@
+inline Real& Matrix22::operator()( int row, int col )
+{
+	Assert( 0 <= row && row < 2 && 0 <= col && col < 2, "illegal matrix look-up" );
+	return m_data[row * 2 + col];
+}
+
+inline const Real& Matrix22::operator()( int row, int col ) const
+{
+	Assert( 0 <= row && row < 2 && 0 <= col && col < 2, "illegal matrix look-up" );
+	return m_data[row * 2 + col];
+}
+
+inline void Matrix22::set( const Real m00, const Real m01, const Real m10, const Real m11 )
+{
+	m_data[0] = m00;
+	m_data[1] = m01;
+	m_data[2] = m10;
+	m_data[3] = m11;
+}
+
+inline void Matrix22::setZero()
+{
+	set( 0.f, 0.f, 0.f, 0.f );
+}
+
+inline void Matrix22::setIdentity()
+{
+	set( 1.f, 0.f, 0.f, 1.f );
+}
+
+inline Real Matrix22::getDeterminant() const
+{
+	return m_data[0] * m_data[3] - m_data[1] * m_data[2];
+}
+
+inline bool Matrix22::setInverse( const Matrix22& m )
+{
+	const Real det = m.getDeterminant();
+
+	if ( det == 0.f )
+	{
+		setZero();
+		return false;
+	}
+
+	const Real invDet = 1.f / det;
+	set( m.m_data[3] * invDet, -m.m_data[1] * invDet,
+		 -m.m_data[2] * invDet, m.m_data[0] * invDet );
+	return true;
+}
+
+inline Vector4 Matrix22::mul( const Vector4& v ) const
+{
+	return Vector4( m_data[0] * v( 0 ) + m_data[1] * v( 1 ),
+					m_data[2] * v( 0 ) + m_data[3] * v( 1 ) );
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Rotation about z-axis kept as unit complex number ( cos, sin ), so rotating vectors takes no trig
+// Integrated by small angles and renormalized
+class Rotation
+{
+public:
+
+	Rotation();
+	Rotation( const Real cosine, const Real sine );
+	explicit Rotation( const Real angle );
+
+	inline void set( const Real angle );
+	inline void setIdentity();
+
+	// Set into rotation by angle of a followed by angle of b
+	inline void setMul( const Rotation& a, const Rotation& b );
+	inline void setInverse( const Rotation& r );
+
+	// Advance by small angle, e.g. angular speed times time step
+	inline void integrate( const Real deltaAngle );
+
+	inline Real getCos() const { return m_cos; }
+	inline Real getSin() const { return m_sin; }
+
+	// Angle in ( -pi, pi ]
+	inline Real getAngle() const;
+
+private:
+
+	Real m_cos;
+	Real m_sin;
+};
+
+#include <Common/Rotation.inl>
@@ -0,0 +1,62 @@
+inline Rotation::Rotation()
+{
+	setIdentity();
+}
+
+inline Rotation::Rotation( const Real cosine, const Real sine ) :
+	m_cos( cosine ),
+	m_sin( sine )
+{
+
+}
+
+inline Rotation::Rotation( const Real angle )
+{
+	set( angle );
+}
+
+inline void Rotation::set( const Real angle )
+{
+	m_cos = cos( angle );
+	m_sin = sin( angle );
+}
+
+inline void Rotation::setIdentity()
+{
+	m_cos = 1.f;
+	m_sin = 0.f;
+}
+
+inline void Rotation::setMul( const Rotation& a, const Rotation& b )
+{
+	const Real c = a.m_cos * b.m_cos - a.m_sin * b.m_sin;
+	const Real s = a.m_sin * b.m_cos + a.m_cos * b.m_sin;
+	m_cos = c;
+	m_sin = s;
+}
+
+inline void Rotation::setInverse( const Rotation& r )
+{
+	m_cos = r.m_cos;
+	m_sin = -r.m_sin;
+}
+
+inline void Rotation::integrate( const Real deltaAngle )
+{
+	// Rotate by cos and sin of deltaAngle from their Taylor series, then back onto unit circle
+	// Turns by deltaAngle within O( deltaAngle^7 ), so stays in step with angle accumulated alongside
+	const Real deltaAngleSq = deltaAngle * deltaAngle;
+	const Real cosine = 1.f - 0.5f * deltaAngleSq * ( 1.f - deltaAngleSq / 12.f );
+	const Real sine = deltaAngle * ( 1.f - deltaAngleSq / 6.f * ( 1.f - deltaAngleSq / 20.f ) );
+	const Rotation increment( cosine, sine );
+	setMul( *this, increment );
+
+	const Real invLength = 1.f / sqrt( m_cos * m_cos + m_sin * m_sin );
+	m_cos *= invLength;
+	m_sin *= invLength;
+}
+
+inline Real Rotation::getAngle() const
+{
+	return atan2( m_sin, m_cos );
+}
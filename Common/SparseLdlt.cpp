@@ -0,0 +1,148 @@
+#include <Common/Base.h>
+
+//
+// SparseLdlt class non-inline functions
+SparseLdlt::SparseLdlt() :
+	m_size( 0 )
+{
+
+}
+
+void SparseLdlt::analyze( const SymmetricSparseMatrix& m )
+{
+	m_size = m.getSize();
+
+	m_parents.resize( m_size );
+	m_colCounts.resize( m_size );
+	m_flags.resize( m_size );
+
+	// Row k of L holds the columns reached walking the elimination tree up from each entry of column k of A
+	for ( int k = 0; k < m_size; k++ )
+	{
+		m_parents[k] = -1;
+		m_flags[k] = k;
+		m_colCounts[k] = 0;
+
+		for ( int p = m.getColumnBegin( k ); p < m.getColumnBegin( k + 1 ); p++ )
+		{
+			for ( int i = m.getEntryRow( p ); m_flags[i] != k; i = m_parents[i] )
+			{
+				if ( m_parents[i] == -1 )
+				{
+					m_parents[i] = k;
+				}
+
+				m_colCounts[i]++;
+				m_flags[i] = k;
+			}
+		}
+	}
+
+	m_colStarts.resize( m_size + 1 );
+	m_colStarts[0] = 0;
+
+	for ( int k = 0; k < m_size; k++ )
+	{
+		m_colStarts[k + 1] = m_colStarts[k] + m_colCounts[k];
+	}
+
+	m_rows.resize( m_colStarts[m_size] );
+	m_values.resize( m_colStarts[m_size] );
+	m_diagonal.resize( m_size );
+	m_y.resize( m_size );
+	m_pattern.resize( m_size );
+}
+
+int SparseLdlt::factorize( const SymmetricSparseMatrix& m, const Real pivotTolerance )
+{
+	Assert( m.getSize() == m_size, "factorizing matrix of other size than analyzed" );
+
+	int numDependentRows = 0;
+
+	// Row k of L is found by solving with the k x k leading factor, whose pattern is the tree walk of analyze()
+	for ( int k = 0; k < m_size; k++ )
+	{
+		m_y[k] = 0.f;
+		int top = m_size;
+		m_flags[k] = k;
+		m_colCounts[k] = 0;
+
+		for ( int p = m.getColumnBegin( k ); p < m.getColumnBegin( k + 1 ); p++ )
+		{
+			int i = m.getEntryRow( p );
+			m_y[i] += m.getEntryValue( p );
+
+			int len = 0;
+			for ( ; m_flags[i] != k; i = m_parents[i] )
+			{
+				m_pattern[len++] = i;
+				m_flags[i] = k;
+			}
+
+			while ( len > 0 )
+			{
+				m_pattern[--top] = m_pattern[--len];
+			}
+		}
+
+		const Real diagonal = m_y[k];
+		m_diagonal[k] = diagonal;
+		m_y[k] = 0.f;
+
+		for ( ; top < m_size; top++ )
+		{
+			const int i = m_pattern[top];
+			const Real yi = m_y[i];
+			m_y[i] = 0.f;
+
+			const int end = m_colStarts[i] + m_colCounts[i];
+			for ( int p = m_colStarts[i]; p < end; p++ )
+			{
+				m_y[m_rows[p]] -= m_values[p] * yi;
+			}
+
+			const Real lki = ( m_diagonal[i] != 0.f ) ? yi / m_diagonal[i] : 0.f;
+			m_diagonal[k] -= lki * yi;
+			m_rows[end] = k;
+			m_values[end] = lki;
+			m_colCounts[i]++;
+		}
+
+		if ( m_diagonal[k] <= pivotTolerance * diagonal )
+		{
+			m_diagonal[k] = 0.f;
+			numDependentRows++;
+		}
+	}
+
+	return numDependentRows;
+}
+
+void SparseLdlt::solve( std::vector<Real>& x ) const
+{
+	Assert( ( int )x.size() >= m_size, "solving with too short vector" );
+
+	// L y = b
+	for ( int j = 0; j < m_size; j++ )
+	{
+		for ( int p = m_colStarts[j]; p < m_colStarts[j + 1]; p++ )
+		{
+			x[m_rows[p]] -= m_values[p] * x[j];
+		}
+	}
+
+	// D z = y
+	for ( int j = 0; j < m_size; j++ )
+	{
+		x[j] = ( m_diagonal[j] != 0.f ) ? x[j] / m_diagonal[j] : 0.f;
+	}
+
+	// L^T x = z
+	for ( int j = m_size - 1; j >= 0; j-- )
+	{
+		for ( int p = m_colStarts[j]; p < m_colStarts[j + 1]; p++ )
+		{
+			x[j] -= m_values[p] * x[m_rows[p]];
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+class SymmetricSparseMatrix;
+
+// LDL^T factorization of a sparse symmetric positive definite matrix, up-looking as in Davis' LDL
+// analyze() finds the elimination tree and pattern of L from the matrix pattern alone, so it is
+// only re-run when the pattern changes while factorize() is re-run for new values
+// No fill reducing ordering is done, rows and columns are factored in the order given
+class SparseLdlt
+{
+public:
+
+	SparseLdlt();
+
+	void analyze( const SymmetricSparseMatrix& m );
+
+	// Matrix must have the pattern last analyzed, returns number of dependent rows
+	// A row whose pivot falls to pivotTolerance times its diagonal or less depends on earlier rows,
+	// i.e. the matrix is singular, and gets zero in solutions instead of the factorization failing
+	int factorize( const SymmetricSparseMatrix& m, const Real pivotTolerance );
+
+	// Solve in place, x holds the right hand side and receives the solution
+	void solve( std::vector<Real>& x ) const;
+
+	int getSize() const { return m_size; }
+
+	// Entries of L below the diagonal, i.e. fill of the factorization
+	int getNumEntries() const { return m_colStarts.empty() ? 0 : m_colStarts.back(); }
+
+private:
+
+	int m_size;
+
+	std::vector<int> m_parents;   // Elimination tree, -1 for roots
+	std::vector<int> m_colCounts; // Entries of each column of L
+	std::vector<int> m_colStarts; // Column col of L spans [m_colStarts[col], m_colStarts[col + 1])
+
+	std::vector<int> m_rows;
+	std::vector<Real> m_values;
+	std::vector<Real> m_diagonal; // Zero for dependent rows
+
+	// Scratch used while factorizing
+	std::vector<Real> m_y;
+	std::vector<int> m_pattern;
+	std::vector<int> m_flags;
+};
@@ -0,0 +1,23 @@
+#include <Common/Base.h>
+
+//
+// SymmetricSparseMatrix class non-inline functions
+SymmetricSparseMatrix::SymmetricSparseMatrix() :
+	m_size( 0 )
+{
+	m_colStarts.push_back( 0 );
+}
+
+void SymmetricSparseMatrix::beginPattern( int size )
+{
+	m_size = size;
+	m_colStarts.assign( 1, 0 );
+	m_rows.clear();
+	m_values.clear();
+}
+
+void SymmetricSparseMatrix::endColumn()
+{
+	Assert( ( int )m_colStarts.size() <= m_size, "too many sparse columns" );
+	m_colStarts.push_back( ( int )m_rows.size() );
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+// Sparse symmetric matrix, only the upper triangle is stored column by column (compressed sparse column)
+// Pattern is built once column after column, values can then be re-filled any number of times without allocating
+class SymmetricSparseMatrix
+{
+public:
+
+	SymmetricSparseMatrix();
+
+	// Start an empty pattern of size x size
+	void beginPattern( int size );
+
+	// Add entry at row of the current column, rows must not exceed the column and no row may be added twice
+	inline void addEntry( int row );
+
+	// Move on to the next column, called once per column
+	void endColumn();
+
+	inline int getSize() const;
+
+	inline int getNumEntries() const;
+
+	// Entries of column col span [getColumnBegin( col ), getColumnBegin( col + 1 ))
+	inline int getColumnBegin( int col ) const;
+
+	inline int getEntryRow( int entryIdx ) const;
+
+	inline Real& getEntryValue( int entryIdx );
+
+	inline const Real& getEntryValue( int entryIdx ) const;
+
+private:
+
+	int m_size;
+	std::vector<int> m_colStarts;
+	std::vector<int> m_rows;
+	std::vector<Real> m_values;
+};
+
+#include <Common/SparseMatrix.inl>
@@ -0,0 +1,37 @@
+inline void SymmetricSparseMatrix::addEntry( int row )
+{
+	Assert( 0 <= row && row <= ( int )m_colStarts.size() - 1, "sparse entry below diagonal" );
+	m_rows.push_back( row );
+	m_values.push_back( 0.f );
+}
+
+inline int SymmetricSparseMatrix::getSize() const
+{
+	return m_size;
+}
+
+inline int SymmetricSparseMatrix::getNumEntries() const
+{
+	return ( int )m_rows.size();
+}
+
+inline int SymmetricSparseMatrix::getColumnBegin( int col ) const
+{
+	Assert( 0 <= col && col < ( int )m_colStarts.size(), "illegal sparse column look-up" );
+	return m_colStarts[col];
+}
+
+inline int SymmetricSparseMatrix::getEntryRow( int entryIdx ) const
+{
+	return m_rows[entryIdx];
+}
+
+inline Real& SymmetricSparseMatrix::getEntryValue( int entryIdx )
+{
+	return m_values[entryIdx];
+}
+
+inline const Real& SymmetricSparseMatrix::getEntryValue( int entryIdx ) const
+{
+	return m_values[entryIdx];
+}
@@ -12,4 +12,11 @@ Transform::Transform( const Vector4& position, const Real rotation )
 	setIdentity();
 	addTranslation( position );
 	addRotation( rotation );
+}
+
+Transform::Transform( const Vector4& position, const Real rotation, const Rotation& cosSin )
+{
+	setIdentity();
+	addTranslation( position );
+	addRotation( rotation, cosSin );
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 class Vector4;
+class Rotation;
 
 // Homogeneous transformation matrix which stores 2d translation and z-axis rotation in a 3-by-3
 // Capable of multiplying with other transformation matrices to produce combined transforms
@@ -22,6 +23,9 @@ public:
 	// Sets into T = Lt * Rt ( Rotation applied then translation )
 	Transform( const Vector4& translation, const Real rotation );
 
+	// Same as above with rotation given also as cos and sin, which have to match it
+	Transform( const Vector4& translation, const Real rotation, const Rotation& cosSin );
+
 	inline const Real& operator()( int i, int j ) const;
 
 	inline void setIdentity();
@@ -38,6 +42,7 @@ public:
 
 	// Sets rotational component of this matrix
 	inline void addRotation( const Real rotation );
+	inline void addRotation( const Real rotation, const Rotation& cosSin );
 
 	// Sets into pure rotation matrix
 	inline void setRotation( const Real rotation );
@@ -46,6 +51,9 @@ public:
 	// Always inverse(Rt) == -Rt
 	inline Real getRotation() const;
 
+	// Gets rotational component as cos and sin, without trig
+	inline void getRotation( Rotation& rotationOut ) const;
+
 	// Sets into matrix with translational and rotational components
 	inline void setTransform( const Vector4& translation, const Real rotation );
 
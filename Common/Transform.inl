@@ -60,6 +60,13 @@ inline void Transform::addRotation( const Real rotation )
 	m_rotation = rotation;
 }
 
+inline void Transform::addRotation( const Real rotation, const Rotation& cosSin )
+{
+	m_data[0][0] = cosSin.getCos(); m_data[0][1] = -cosSin.getSin();
+	m_data[1][0] = cosSin.getSin(); m_data[1][1] = cosSin.getCos();
+	m_rotation = rotation;
+}
+
 inline void Transform::setRotation( const Real rotation )
 {
 	setIdentity();
@@ -71,6 +78,11 @@ inline Real Transform::getRotation() const
 	return m_rotation;
 }
 
+inline void Transform::getRotation( Rotation& rotationOut ) const
+{
+	rotationOut = Rotation( m_data[0][0], m_data[1][0] );
+}
+
 inline void Transform::setTransform( const Vector4& translation, const Real rotation )
 {
 	setIdentity();
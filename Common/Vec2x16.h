@@ -0,0 +1,119 @@
+#pragma once
+
+#include <immintrin.h>
+
+// Sixteen-wide counterparts of Realx4 and Vec2x4 using AVX-512 F
+// Not included from Base.h, only include from translation units compiled for AVX-512
+// and only run their code after checking the CPU supports it
+
+// Comparisons of AVX-512 give a bit per lane instead of a lane mask
+class Maskx16
+{
+public:
+
+	Maskx16( const __mmask16 mask ) : m_mask( mask ) {}
+
+	inline const Maskx16 operator&( const Maskx16& rhs ) const { return ( __mmask16 )( m_mask & rhs.m_mask ); }
+	inline const Maskx16 operator|( const Maskx16& rhs ) const { return ( __mmask16 )( m_mask | rhs.m_mask ); }
+
+	// Bit i set when lane i of mask is set
+	inline int getMask() const { return m_mask; }
+
+	__mmask16 m_mask;
+};
+
+class Realx16
+{
+public:
+
+	static const int WIDTH = 16;
+
+	Realx16() {}
+	Realx16( const __m512 vals ) : m_vals( vals ) {}
+	explicit Realx16( const Real val ) : m_vals( _mm512_set1_ps( val ) ) {}
+
+	// Unaligned load and store of sixteen consecutive reals
+	static inline Realx16 load( const Real* src );
+	inline void store( Real* dst ) const;
+
+	// Lane i from base[indices[i] * stride], stride in reals
+	static inline Realx16 gather( const Real* base, const int* indices, const int stride );
+	inline void scatter( Real* base, const int* indices, const int stride ) const;
+
+	inline void setZero();
+	inline void setAll( const Real val );
+
+	// *this = a * b + c, fused
+	inline void setMulAdd( const Realx16& a, const Realx16& b, const Realx16& c );
+
+	inline void setSqrt( const Realx16& v );
+	inline void setAbs( const Realx16& v );
+	inline void setMin( const Realx16& a, const Realx16& b );
+	inline void setMax( const Realx16& a, const Realx16& b );
+
+	// Lanes of a where mask is set, lanes of b elsewhere
+	inline void setSelect( const Maskx16& mask, const Realx16& a, const Realx16& b );
+
+	inline const Realx16 operator+( const Realx16& other ) const { return _mm512_add_ps( m_vals, other.m_vals ); }
+	inline const Realx16 operator-( const Realx16& other ) const { return _mm512_sub_ps( m_vals, other.m_vals ); }
+	inline const Realx16 operator*( const Realx16& other ) const { return _mm512_mul_ps( m_vals, other.m_vals ); }
+	inline const Realx16 operator/( const Realx16& other ) const { return _mm512_div_ps( m_vals, other.m_vals ); }
+	inline const Realx16 operator-() const { return _mm512_sub_ps( _mm512_setzero_ps(), m_vals ); }
+
+	// Masks
+	inline const Maskx16 operator<( const Realx16& rhs ) const { return _mm512_cmp_ps_mask( m_vals, rhs.m_vals, _CMP_LT_OQ ); }
+	inline const Maskx16 operator<=( const Realx16& rhs ) const { return _mm512_cmp_ps_mask( m_vals, rhs.m_vals, _CMP_LE_OQ ); }
+	inline const Maskx16 operator>( const Realx16& rhs ) const { return _mm512_cmp_ps_mask( m_vals, rhs.m_vals, _CMP_GT_OQ ); }
+	inline const Maskx16 operator>=( const Realx16& rhs ) const { return _mm512_cmp_ps_mask( m_vals, rhs.m_vals, _CMP_GE_OQ ); }
+
+	__m512 m_vals;
+};
+
+class Vec2x16
+{
+public:
+
+	static const int WIDTH = Realx16::WIDTH;
+
+	Vec2x16() {}
+	Vec2x16( const Realx16& x, const Realx16& y ) : m_x( x ), m_y( y ) {}
+
+	// Sixteen vectors from consecutive x and consecutive y values
+	static inline Vec2x16 load( const Real* xs, const Real* ys );
+	inline void store( Real* xs, Real* ys ) const;
+
+	inline void setZero();
+
+	// All lanes set to v
+	inline void setAll( const Vector4& v );
+
+	inline void setAdd( const Vec2x16& a, const Vec2x16& b );
+	inline void setSub( const Vec2x16& a, const Vec2x16& b );
+	inline void setMul( const Vec2x16& v, const Realx16& scale );
+
+	// *this = a + b * scale
+	inline void setAddMul( const Vec2x16& a, const Vec2x16& b, const Realx16& scale );
+
+	// Rotate each vector by its lane's cos and sin
+	inline void setRotated( const Vec2x16& v, const Realx16& cosine, const Realx16& sine );
+	inline void setInverseRotated( const Vec2x16& v, const Realx16& cosine, const Realx16& sine );
+
+	inline void setMin( const Vec2x16& a, const Vec2x16& b );
+	inline void setMax( const Vec2x16& a, const Vec2x16& b );
+	inline void setSelect( const Maskx16& mask, const Vec2x16& a, const Vec2x16& b );
+
+	inline Realx16 dot( const Vec2x16& other ) const;
+
+	// z of 3D cross product, x * other.y - y * other.x
+	inline Realx16 cross( const Vec2x16& other ) const;
+
+	inline Realx16 lengthSquared() const;
+
+	// Single vector of lane i
+	inline Vector4 getLane( int i ) const;
+
+	Realx16 m_x;
+	Realx16 m_y;
+};
+
+#include <Common/Vec2x16.inl>
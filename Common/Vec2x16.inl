@@ -0,0 +1,165 @@
+inline Realx16 Realx16::load( const Real* src )
+{
+	return _mm512_loadu_ps( src );
+}
+
+inline void Realx16::store( Real* dst ) const
+{
+	_mm512_storeu_ps( dst, m_vals );
+}
+
+inline Realx16 Realx16::gather( const Real* base, const int* indices, const int stride )
+{
+	const __m512i offsets = _mm512_mullo_epi32( _mm512_loadu_si512( indices ), _mm512_set1_epi32( stride ) );
+	return _mm512_i32gather_ps( offsets, base, sizeof( Real ) );
+}
+
+inline void Realx16::scatter( Real* base, const int* indices, const int stride ) const
+{
+	// Lanes writing the same address are written in lane order
+	const __m512i offsets = _mm512_mullo_epi32( _mm512_loadu_si512( indices ), _mm512_set1_epi32( stride ) );
+	_mm512_i32scatter_ps( base, offsets, m_vals, sizeof( Real ) );
+}
+
+inline void Realx16::setZero()
+{
+	m_vals = _mm512_setzero_ps();
+}
+
+inline void Realx16::setAll( const Real val )
+{
+	m_vals = _mm512_set1_ps( val );
+}
+
+inline void Realx16::setMulAdd( const Realx16& a, const Realx16& b, const Realx16& c )
+{
+	m_vals = _mm512_fmadd_ps( a.m_vals, b.m_vals, c.m_vals );
+}
+
+inline void Realx16::setSqrt( const Realx16& v )
+{
+	m_vals = _mm512_sqrt_ps( v.m_vals );
+}
+
+inline void Realx16::setAbs( const Realx16& v )
+{
+	m_vals = _mm512_abs_ps( v.m_vals );
+}
+
+inline void Realx16::setMin( const Realx16& a, const Realx16& b )
+{
+	m_vals = _mm512_min_ps( a.m_vals, b.m_vals );
+}
+
+inline void Realx16::setMax( const Realx16& a, const Realx16& b )
+{
+	m_vals = _mm512_max_ps( a.m_vals, b.m_vals );
+}
+
+inline void Realx16::setSelect( const Maskx16& mask, const Realx16& a, const Realx16& b )
+{
+	m_vals = _mm512_mask_blend_ps( mask.m_mask, b.m_vals, a.m_vals );
+}
+
+inline Vec2x16 Vec2x16::load( const Real* xs, const Real* ys )
+{
+	return Vec2x16( Realx16::load( xs ), Realx16::load( ys ) );
+}
+
+inline void Vec2x16::store( Real* xs, Real* ys ) const
+{
+	m_x.store( xs );
+	m_y.store( ys );
+}
+
+inline void Vec2x16::setZero()
+{
+	m_x.setZero();
+	m_y.setZero();
+}
+
+inline void Vec2x16::setAll( const Vector4& v )
+{
+	m_x.setAll( v( 0 ) );
+	m_y.setAll( v( 1 ) );
+}
+
+inline void Vec2x16::setAdd( const Vec2x16& a, const Vec2x16& b )
+{
+	m_x = a.m_x + b.m_x;
+	m_y = a.m_y + b.m_y;
+}
+
+inline void Vec2x16::setSub( const Vec2x16& a, const Vec2x16& b )
+{
+	m_x = a.m_x - b.m_x;
+	m_y = a.m_y - b.m_y;
+}
+
+inline void Vec2x16::setMul( const Vec2x16& v, const Realx16& scale )
+{
+	m_x = v.m_x * scale;
+	m_y = v.m_y * scale;
+}
+
+inline void Vec2x16::setAddMul( const Vec2x16& a, const Vec2x16& b, const Realx16& scale )
+{
+	m_x.setMulAdd( b.m_x, scale, a.m_x );
+	m_y.setMulAdd( b.m_y, scale, a.m_y );
+}
+
+inline void Vec2x16::setRotated( const Vec2x16& v, const Realx16& cosine, const Realx16& sine )
+{
+	const Realx16 x = cosine * v.m_x - sine * v.m_y;
+	m_y = sine * v.m_x + cosine * v.m_y;
+	m_x = x;
+}
+
+inline void Vec2x16::setInverseRotated( const Vec2x16& v, const Realx16& cosine, const Realx16& sine )
+{
+	const Realx16 x = cosine * v.m_x + sine * v.m_y;
+	m_y = cosine * v.m_y - sine * v.m_x;
+	m_x = x;
+}
+
+inline void Vec2x16::setMin( const Vec2x16& a, const Vec2x16& b )
+{
+	m_x.setMin( a.m_x, b.m_x );
+	m_y.setMin( a.m_y, b.m_y );
+}
+
+inline void Vec2x16::setMax( const Vec2x16& a, const Vec2x16& b )
+{
+	m_x.setMax( a.m_x, b.m_x );
+	m_y.setMax( a.m_y, b.m_y );
+}
+
+inline void Vec2x16::setSelect( const Maskx16& mask, const Vec2x16& a, const Vec2x16& b )
+{
+	m_x.setSelect( mask, a.m_x, b.m_x );
+	m_y.setSelect( mask, a.m_y, b.m_y );
+}
+
+inline Realx16 Vec2x16::dot( const Vec2x16& other ) const
+{
+	Realx16 res; res.setMulAdd( m_x, other.m_x, m_y * other.m_y );
+	return res;
+}
+
+inline Realx16 Vec2x16::cross( const Vec2x16& other ) const
+{
+	return m_x * other.m_y - m_y * other.m_x;
+}
+
+inline Realx16 Vec2x16::lengthSquared() const
+{
+	return dot( *this );
+}
+
+inline Vector4 Vec2x16::getLane( int i ) const
+{
+	Assert( i >= 0 && i < WIDTH, "Looking up invalid lane." );
+	Real xs[WIDTH], ys[WIDTH];
+	store( xs, ys );
+	return Vector4( xs[i], ys[i] );
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <smmintrin.h>
+
+// Four reals processed together, one per SSE lane
+// Comparisons return masks with all bits of passing lanes set, used by select and getMask
+class Realx4
+{
+public:
+
+	static const int WIDTH = 4;
+
+	Realx4() {}
+	Realx4( const __m128 quad ) : m_quad( quad ) {}
+	explicit Realx4( const Real val ) : m_quad( _mm_set1_ps( val ) ) {}
+
+	// Unaligned load and store of four consecutive reals
+	static inline Realx4 load( const Real* src );
+	inline void store( Real* dst ) const;
+
+	// Lane i from base[indices[i] * stride], stride in reals
+	static inline Realx4 gather( const Real* base, const int* indices, const int stride );
+	inline void scatter( Real* base, const int* indices, const int stride ) const;
+
+	inline void setZero();
+	inline void setAll( const Real val );
+
+	// *this = a * b + c
+	inline void setMulAdd( const Realx4& a, const Realx4& b, const Realx4& c );
+
+	inline void setSqrt( const Realx4& v );
+	inline void setAbs( const Realx4& v );
+	inline void setMin( const Realx4& a, const Realx4& b );
+	inline void setMax( const Realx4& a, const Realx4& b );
+
+	// Lanes of a where mask is set, lanes of b elsewhere
+	inline void setSelect( const Realx4& mask, const Realx4& a, const Realx4& b );
+
+	inline const Realx4 operator+( const Realx4& other ) const { return _mm_add_ps( m_quad, other.m_quad ); }
+	inline const Realx4 operator-( const Realx4& other ) const { return _mm_sub_ps( m_quad, other.m_quad ); }
+	inline const Realx4 operator*( const Realx4& other ) const { return _mm_mul_ps( m_quad, other.m_quad ); }
+	inline const Realx4 operator/( const Realx4& other ) const { return _mm_div_ps( m_quad, other.m_quad ); }
+	inline const Realx4 operator-() const { return _mm_sub_ps( _mm_setzero_ps(), m_quad ); }
+
+	// Masks
+	inline const Realx4 operator<( const Realx4& rhs ) const { return _mm_cmplt_ps( m_quad, rhs.m_quad ); }
+	inline const Realx4 operator<=( const Realx4& rhs ) const { return _mm_cmple_ps( m_quad, rhs.m_quad ); }
+	inline const Realx4 operator>( const Realx4& rhs ) const { return _mm_cmpgt_ps( m_quad, rhs.m_quad ); }
+	inline const Realx4 operator>=( const Realx4& rhs ) const { return _mm_cmpge_ps( m_quad, rhs.m_quad ); }
+	inline const Realx4 operator&( const Realx4& rhs ) const { return _mm_and_ps( m_quad, rhs.m_quad ); }
+	inline const Realx4 operator|( const Realx4& rhs ) const { return _mm_or_ps( m_quad, rhs.m_quad ); }
+
+	// Bit i set when lane i of mask is set
+	inline int getMask() const { return _mm_movemask_ps( m_quad ); }
+
+	__m128 m_quad;
+};
+
+// Four 2D vectors kept as a lane of x and a lane of y, so no lane is left unused
+// Meant for batch kernels working on arrays of x and arrays of y, Vector4 remains for single vectors
+class Vec2x4
+{
+public:
+
+	static const int WIDTH = Realx4::WIDTH;
+
+	Vec2x4() {}
+	Vec2x4( const Realx4& x, const Realx4& y ) : m_x( x ), m_y( y ) {}
+
+	// Four vectors from consecutive x and consecutive y values
+	static inline Vec2x4 load( const Real* xs, const Real* ys );
+	inline void store( Real* xs, Real* ys ) const;
+
+	inline void setZero();
+
+	// All lanes set to v
+	inline void setAll( const Vector4& v );
+
+	inline void setAdd( const Vec2x4& a, const Vec2x4& b );
+	inline void setSub( const Vec2x4& a, const Vec2x4& b );
+	inline void setMul( const Vec2x4& v, const Realx4& scale );
+
+	// *this = a + b * scale
+	inline void setAddMul( const Vec2x4& a, const Vec2x4& b, const Realx4& scale );
+
+	// Rotate each vector by its lane's cos and sin
+	inline void setRotated( const Vec2x4& v, const Realx4& cosine, const Realx4& sine );
+	inline void setInverseRotated( const Vec2x4& v, const Realx4& cosine, const Realx4& sine );
+
+	inline void setMin( const Vec2x4& a, const Vec2x4& b );
+	inline void setMax( const Vec2x4& a, const Vec2x4& b );
+	inline void setSelect( const Realx4& mask, const Vec2x4& a, const Vec2x4& b );
+
+	inline Realx4 dot( const Vec2x4& other ) const;
+
+	// z of 3D cross product, x * other.y - y * other.x
+	inline Realx4 cross( const Vec2x4& other ) const;
+
+	inline Realx4 lengthSquared() const;
+
+	// Single vector of lane i
+	inline Vector4 getLane( int i ) const;
+
+	Realx4 m_x;
+	Realx4 m_y;
+};
+
+#include <Common/Vec2x4.inl>
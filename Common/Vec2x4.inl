@@ -0,0 +1,169 @@
+inline Realx4 Realx4::load( const Real* src )
+{
+	return _mm_loadu_ps( src );
+}
+
+inline void Realx4::store( Real* dst ) const
+{
+	_mm_storeu_ps( dst, m_quad );
+}
+
+inline Realx4 Realx4::gather( const Real* base, const int* indices, const int stride )
+{
+	return _mm_set_ps( base[indices[3] * stride], base[indices[2] * stride], base[indices[1] * stride], base[indices[0] * stride] );
+}
+
+inline void Realx4::scatter( Real* base, const int* indices, const int stride ) const
+{
+	Real vals[4];
+	store( vals );
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		base[indices[i] * stride] = vals[i];
+	}
+}
+
+inline void Realx4::setZero()
+{
+	m_quad = _mm_setzero_ps();
+}
+
+inline void Realx4::setAll( const Real val )
+{
+	m_quad = _mm_set1_ps( val );
+}
+
+inline void Realx4::setMulAdd( const Realx4& a, const Realx4& b, const Realx4& c )
+{
+	// No fused multiply-add in SSE
+	m_quad = _mm_add_ps( _mm_mul_ps( a.m_quad, b.m_quad ), c.m_quad );
+}
+
+inline void Realx4::setSqrt( const Realx4& v )
+{
+	m_quad = _mm_sqrt_ps( v.m_quad );
+}
+
+inline void Realx4::setAbs( const Realx4& v )
+{
+	m_quad = _mm_and_ps( v.m_quad, _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) ) );
+}
+
+inline void Realx4::setMin( const Realx4& a, const Realx4& b )
+{
+	m_quad = _mm_min_ps( a.m_quad, b.m_quad );
+}
+
+inline void Realx4::setMax( const Realx4& a, const Realx4& b )
+{
+	m_quad = _mm_max_ps( a.m_quad, b.m_quad );
+}
+
+inline void Realx4::setSelect( const Realx4& mask, const Realx4& a, const Realx4& b )
+{
+	m_quad = _mm_blendv_ps( b.m_quad, a.m_quad, mask.m_quad );
+}
+
+inline Vec2x4 Vec2x4::load( const Real* xs, const Real* ys )
+{
+	return Vec2x4( Realx4::load( xs ), Realx4::load( ys ) );
+}
+
+inline void Vec2x4::store( Real* xs, Real* ys ) const
+{
+	m_x.store( xs );
+	m_y.store( ys );
+}
+
+inline void Vec2x4::setZero()
+{
+	m_x.setZero();
+	m_y.setZero();
+}
+
+inline void Vec2x4::setAll( const Vector4& v )
+{
+	m_x.setAll( v( 0 ) );
+	m_y.setAll( v( 1 ) );
+}
+
+inline void Vec2x4::setAdd( const Vec2x4& a, const Vec2x4& b )
+{
+	m_x = a.m_x + b.m_x;
+	m_y = a.m_y + b.m_y;
+}
+
+inline void Vec2x4::setSub( const Vec2x4& a, const Vec2x4& b )
+{
+	m_x = a.m_x - b.m_x;
+	m_y = a.m_y - b.m_y;
+}
+
+inline void Vec2x4::setMul( const Vec2x4& v, const Realx4& scale )
+{
+	m_x = v.m_x * scale;
+	m_y = v.m_y * scale;
+}
+
+inline void Vec2x4::setAddMul( const Vec2x4& a, const Vec2x4& b, const Realx4& scale )
+{
+	m_x.setMulAdd( b.m_x, scale, a.m_x );
+	m_y.setMulAdd( b.m_y, scale, a.m_y );
+}
+
+inline void Vec2x4::setRotated( const Vec2x4& v, const Realx4& cosine, const Realx4& sine )
+{
+	const Realx4 x = cosine * v.m_x - sine * v.m_y;
+	m_y = sine * v.m_x + cosine * v.m_y;
+	m_x = x;
+}
+
+inline void Vec2x4::setInverseRotated( const Vec2x4& v, const Realx4& cosine, const Realx4& sine )
+{
+	const Realx4 x = cosine * v.m_x + sine * v.m_y;
+	m_y = cosine * v.m_y - sine * v.m_x;
+	m_x = x;
+}
+
+inline void Vec2x4::setMin( const Vec2x4& a, const Vec2x4& b )
+{
+	m_x.setMin( a.m_x, b.m_x );
+	m_y.setMin( a.m_y, b.m_y );
+}
+
+inline void Vec2x4::setMax( const Vec2x4& a, const Vec2x4& b )
+{
+	m_x.setMax( a.m_x, b.m_x );
+	m_y.setMax( a.m_y, b.m_y );
+}
+
+inline void Vec2x4::setSelect( const Realx4& mask, const Vec2x4& a, const Vec2x4& b )
+{
+	m_x.setSelect( mask, a.m_x, b.m_x );
+	m_y.setSelect( mask, a.m_y, b.m_y );
+}
+
+inline Realx4 Vec2x4::dot( const Vec2x4& other ) const
+{
+	Realx4 res; res.setMulAdd( m_x, other.m_x, m_y * other.m_y );
+	return res;
+}
+
+inline Realx4 Vec2x4::cross( const Vec2x4& other ) const
+{
+	return m_x * other.m_y - m_y * other.m_x;
+}
+
+inline Realx4 Vec2x4::lengthSquared() const
+{
+	return dot( *this );
+}
+
+inline Vector4 Vec2x4::getLane( int i ) const
+{
+	Assert( i >= 0 && i < WIDTH, "Looking up invalid lane." );
+	Real xs[WIDTH], ys[WIDTH];
+	store( xs, ys );
+	return Vector4( xs[i], ys[i] );
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <immintrin.h>
+
+// Eight-wide counterparts of Realx4 and Vec2x4 using AVX2 and FMA
+// Not included from Base.h, only include from translation units compiled for AVX2
+// and only run their code after checking the CPU supports it
+
+class Realx8
+{
+public:
+
+	static const int WIDTH = 8;
+
+	Realx8() {}
+	Realx8( const __m256 oct ) : m_oct( oct ) {}
+	explicit Realx8( const Real val ) : m_oct( _mm256_set1_ps( val ) ) {}
+
+	// Unaligned load and store of eight consecutive reals
+	static inline Realx8 load( const Real* src );
+	inline void store( Real* dst ) const;
+
+	// Lane i from base[indices[i] * stride], stride in reals
+	static inline Realx8 gather( const Real* base, const int* indices, const int stride );
+	inline void scatter( Real* base, const int* indices, const int stride ) const;
+
+	inline void setZero();
+	inline void setAll( const Real val );
+
+	// *this = a * b + c, fused
+	inline void setMulAdd( const Realx8& a, const Realx8& b, const Realx8& c );
+
+	inline void setSqrt( const Realx8& v );
+	inline void setAbs( const Realx8& v );
+	inline void setMin( const Realx8& a, const Realx8& b );
+	inline void setMax( const Realx8& a, const Realx8& b );
+
+	// Lanes of a where mask is set, lanes of b elsewhere
+	inline void setSelect( const Realx8& mask, const Realx8& a, const Realx8& b );
+
+	inline const Realx8 operator+( const Realx8& other ) const { return _mm256_add_ps( m_oct, other.m_oct ); }
+	inline const Realx8 operator-( const Realx8& other ) const { return _mm256_sub_ps( m_oct, other.m_oct ); }
+	inline const Realx8 operator*( const Realx8& other ) const { return _mm256_mul_ps( m_oct, other.m_oct ); }
+	inline const Realx8 operator/( const Realx8& other ) const { return _mm256_div_ps( m_oct, other.m_oct ); }
+	inline const Realx8 operator-() const { return _mm256_sub_ps( _mm256_setzero_ps(), m_oct ); }
+
+	// Masks
+	inline const Realx8 operator<( const Realx8& rhs ) const { return _mm256_cmp_ps( m_oct, rhs.m_oct, _CMP_LT_OQ ); }
+	inline const Realx8 operator<=( const Realx8& rhs ) const { return _mm256_cmp_ps( m_oct, rhs.m_oct, _CMP_LE_OQ ); }
+	inline const Realx8 operator>( const Realx8& rhs ) const { return _mm256_cmp_ps( m_oct, rhs.m_oct, _CMP_GT_OQ ); }
+	inline const Realx8 operator>=( const Realx8& rhs ) const { return _mm256_cmp_ps( m_oct, rhs.m_oct, _CMP_GE_OQ ); }
+	inline const Realx8 operator&( const Realx8& rhs ) const { return _mm256_and_ps( m_oct, rhs.m_oct ); }
+	inline const Realx8 operator|( const Realx8& rhs ) const { return _mm256_or_ps( m_oct, rhs.m_oct ); }
+
+	// Bit i set when lane i of mask is set
+	inline int getMask() const { return _mm256_movemask_ps( m_oct ); }
+
+	__m256 m_oct;
+};
+
+class Vec2x8
+{
+public:
+
+	static const int WIDTH = Realx8::WIDTH;
+
+	Vec2x8() {}
+	Vec2x8( const Realx8& x, const Realx8& y ) : m_x( x ), m_y( y ) {}
+
+	// Eight vectors from consecutive x and consecutive y values
+	static inline Vec2x8 load( const Real* xs, const Real* ys );
+	inline void store( Real* xs, Real* ys ) const;
+
+	inline void setZero();
+
+	// All lanes set to v
+	inline void setAll( const Vector4& v );
+
+	inline void setAdd( const Vec2x8& a, const Vec2x8& b );
+	inline void setSub( const Vec2x8& a, const Vec2x8& b );
+	inline void setMul( const Vec2x8& v, const Realx8& scale );
+
+	// *this = a + b * scale
+	inline void setAddMul( const Vec2x8& a, const Vec2x8& b, const Realx8& scale );
+
+	// Rotate each vector by its lane's cos and sin
+	inline void setRotated( const Vec2x8& v, const Realx8& cosine, const Realx8& sine );
+	inline void setInverseRotated( const Vec2x8& v, const Realx8& cosine, const Realx8& sine );
+
+	inline void setMin( const Vec2x8& a, const Vec2x8& b );
+	inline void setMax( const Vec2x8& a, const Vec2x8& b );
+	inline void setSelect( const Realx8& mask, const Vec2x8& a, const Vec2x8& b );
+
+	inline Realx8 dot( const Vec2x8& other ) const;
+
+	// z of 3D cross product, x * other.y - y * other.x
+	inline Realx8 cross( const Vec2x8& other ) const;
+
+	inline Realx8 lengthSquared() const;
+
+	// Single vector of lane i
+	inline Vector4 getLane( int i ) const;
+
+	Realx8 m_x;
+	Realx8 m_y;
+};
+
+#include <Common/Vec2x8.inl>
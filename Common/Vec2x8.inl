@@ -0,0 +1,170 @@
+inline Realx8 Realx8::load( const Real* src )
+{
+	return _mm256_loadu_ps( src );
+}
+
+inline void Realx8::store( Real* dst ) const
+{
+	_mm256_storeu_ps( dst, m_oct );
+}
+
+inline Realx8 Realx8::gather( const Real* base, const int* indices, const int stride )
+{
+	const __m256i offsets = _mm256_mullo_epi32( _mm256_loadu_si256( ( const __m256i* )indices ), _mm256_set1_epi32( stride ) );
+	return _mm256_i32gather_ps( base, offsets, sizeof( Real ) );
+}
+
+inline void Realx8::scatter( Real* base, const int* indices, const int stride ) const
+{
+	// No scatter instruction in AVX2
+	Real vals[8];
+	store( vals );
+
+	for ( int i = 0; i < 8; i++ )
+	{
+		base[indices[i] * stride] = vals[i];
+	}
+}
+
+inline void Realx8::setZero()
+{
+	m_oct = _mm256_setzero_ps();
+}
+
+inline void Realx8::setAll( const Real val )
+{
+	m_oct = _mm256_set1_ps( val );
+}
+
+inline void Realx8::setMulAdd( const Realx8& a, const Realx8& b, const Realx8& c )
+{
+	m_oct = _mm256_fmadd_ps( a.m_oct, b.m_oct, c.m_oct );
+}
+
+inline void Realx8::setSqrt( const Realx8& v )
+{
+	m_oct = _mm256_sqrt_ps( v.m_oct );
+}
+
+inline void Realx8::setAbs( const Realx8& v )
+{
+	m_oct = _mm256_and_ps( v.m_oct, _mm256_castsi256_ps( _mm256_set1_epi32( 0x7fffffff ) ) );
+}
+
+inline void Realx8::setMin( const Realx8& a, const Realx8& b )
+{
+	m_oct = _mm256_min_ps( a.m_oct, b.m_oct );
+}
+
+inline void Realx8::setMax( const Realx8& a, const Realx8& b )
+{
+	m_oct = _mm256_max_ps( a.m_oct, b.m_oct );
+}
+
+inline void Realx8::setSelect( const Realx8& mask, const Realx8& a, const Realx8& b )
+{
+	m_oct = _mm256_blendv_ps( b.m_oct, a.m_oct, mask.m_oct );
+}
+
+inline Vec2x8 Vec2x8::load( const Real* xs, const Real* ys )
+{
+	return Vec2x8( Realx8::load( xs ), Realx8::load( ys ) );
+}
+
+inline void Vec2x8::store( Real* xs, Real* ys ) const
+{
+	m_x.store( xs );
+	m_y.store( ys );
+}
+
+inline void Vec2x8::setZero()
+{
+	m_x.setZero();
+	m_y.setZero();
+}
+
+inline void Vec2x8::setAll( const Vector4& v )
+{
+	m_x.setAll( v( 0 ) );
+	m_y.setAll( v( 1 ) );
+}
+
+inline void Vec2x8::setAdd( const Vec2x8& a, const Vec2x8& b )
+{
+	m_x = a.m_x + b.m_x;
+	m_y = a.m_y + b.m_y;
+}
+
+inline void Vec2x8::setSub( const Vec2x8& a, const Vec2x8& b )
+{
+	m_x = a.m_x - b.m_x;
+	m_y = a.m_y - b.m_y;
+}
+
+inline void Vec2x8::setMul( const Vec2x8& v, const Realx8& scale )
+{
+	m_x = v.m_x * scale;
+	m_y = v.m_y * scale;
+}
+
+inline void Vec2x8::setAddMul( const Vec2x8& a, const Vec2x8& b, const Realx8& scale )
+{
+	m_x.setMulAdd( b.m_x, scale, a.m_x );
+	m_y.setMulAdd( b.m_y, scale, a.m_y );
+}
+
+inline void Vec2x8::setRotated( const Vec2x8& v, const Realx8& cosine, const Realx8& sine )
+{
+	const Realx8 x = cosine * v.m_x - sine * v.m_y;
+	m_y = sine * v.m_x + cosine * v.m_y;
+	m_x = x;
+}
+
+inline void Vec2x8::setInverseRotated( const Vec2x8& v, const Realx8& cosine, const Realx8& sine )
+{
+	const Realx8 x = cosine * v.m_x + sine * v.m_y;
+	m_y = cosine * v.m_y - sine * v.m_x;
+	m_x = x;
+}
+
+inline void Vec2x8::setMin( const Vec2x8& a, const Vec2x8& b )
+{
+	m_x.setMin( a.m_x, b.m_x );
+	m_y.setMin( a.m_y, b.m_y );
+}
+
+inline void Vec2x8::setMax( const Vec2x8& a, const Vec2x8& b )
+{
+	m_x.setMax( a.m_x, b.m_x );
+	m_y.setMax( a.m_y, b.m_y );
+}
+
+inline void Vec2x8::setSelect( const Realx8& mask, const Vec2x8& a, const Vec2x8& b )
+{
+	m_x.setSelect( mask, a.m_x, b.m_x );
+	m_y.setSelect( mask, a.m_y, b.m_y );
+}
+
+inline Realx8 Vec2x8::dot( const Vec2x8& other ) const
+{
+	Realx8 res; res.setMulAdd( m_x, other.m_x, m_y * other.m_y );
+	return res;
+}
+
+inline Realx8 Vec2x8::cross( const Vec2x8& other ) const
+{
+	return m_x * other.m_y - m_y * other.m_x;
+}
+
+inline Realx8 Vec2x8::lengthSquared() const
+{
+	return dot( *this );
+}
+
+inline Vector4 Vec2x8::getLane( int i ) const
+{
+	Assert( i >= 0 && i < WIDTH, "Looking up invalid lane." );
+	Real xs[WIDTH], ys[WIDTH];
+	store( xs, ys );
+	return Vector4( xs[i], ys[i] );
+}
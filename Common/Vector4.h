@@ -1,8 +1,9 @@
 #pragma once
 
-#include <nmmintrin.h>
+#include <smmintrin.h> // SSE4.1 is the baseline, wider kernels are picked at runtime in physicsKernels
 
 class Transform;
+class Rotation;
 
 class Vector4
 {
@@ -42,6 +43,8 @@ public:
 
 	inline void setRotatedDir( const Vector4& v, const Real angle );
 	inline void setRotatedDir( const Real angle );
+	inline void setRotatedDir( const Vector4& v, const Rotation& rotation );
+	inline void setInverseRotatedDir( const Vector4& v, const Rotation& rotation );
 
 	template <int N>
 	inline void setNormalized( const Vector4& a );
@@ -97,6 +100,8 @@ public:
 	inline Real lengthSquared4() const;
 
 	inline Vector4 getRotatedDir( const Real a ) const;
+	inline Vector4 getRotatedDir( const Rotation& rotation ) const;
+	inline Vector4 getInverseRotatedDir( const Rotation& rotation ) const;
 
 	template <int N>
 	inline Vector4 getNormalized() const;
@@ -75,7 +75,13 @@ inline void Vector4::setDot( const Vector4& a, const Vector4& b )
 {
 	Assert( N >= 1 && N <= 4, "Dotting invalid # of elements" );
 	if ( N == 1 )      m_quad = _mm_dp_ps( a.m_quad, b.m_quad, 0x1F );
-	else if ( N == 2 ) m_quad = _mm_dp_ps( a.m_quad, b.m_quad, 0x3F );
+	else if ( N == 2 )
+	{
+		// Multiply and one shuffled add, dpps is slow for two elements
+		const __m128 mul = _mm_mul_ps( a.m_quad, b.m_quad );
+		const __m128 sum = _mm_add_ps( mul, _mm_shuffle_ps( mul, mul, _MM_SHUFFLE( 0, 0, 0, 1 ) ) );
+		m_quad = _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+	}
 	else if ( N == 3 ) m_quad = _mm_dp_ps( a.m_quad, b.m_quad, 0x7F );
 	else if ( N == 4 ) m_quad = _mm_dp_ps( a.m_quad, b.m_quad, 0xFF );
 }
@@ -117,6 +123,20 @@ inline void Vector4::setRotatedDir( const Real angle )
 	( *this )( 0 ) = xbuf;
 }
 
+inline void Vector4::setRotatedDir( const Vector4& v, const Rotation& rotation )
+{
+	Real xbuf = rotation.getCos()*v( 0 ) - rotation.getSin()*v( 1 );
+	( *this )( 1 ) = rotation.getSin()*v( 0 ) + rotation.getCos()*v( 1 );
+	( *this )( 0 ) = xbuf;
+}
+
+inline void Vector4::setInverseRotatedDir( const Vector4& v, const Rotation& rotation )
+{
+	Real xbuf = rotation.getCos()*v( 0 ) + rotation.getSin()*v( 1 );
+	( *this )( 1 ) = -rotation.getSin()*v( 0 ) + rotation.getCos()*v( 1 );
+	( *this )( 0 ) = xbuf;
+}
+
 template <int N>
 inline void Vector4::setNormalized( const Vector4& a )
 {
@@ -315,6 +335,18 @@ inline Vector4 Vector4::getRotatedDir( const Real angle ) const
 	return res;
 }
 
+inline Vector4 Vector4::getRotatedDir( const Rotation& rotation ) const
+{
+	Vector4 res; res.setRotatedDir( *this, rotation );
+	return res;
+}
+
+inline Vector4 Vector4::getInverseRotatedDir( const Rotation& rotation ) const
+{
+	Vector4 res; res.setInverseRotatedDir( *this, rotation );
+	return res;
+}
+
 template <int N>
 inline Vector4 Vector4::getNormalized() const
 {
@@ -30,7 +30,7 @@ struct MousePickingContext
 	}
 
 	Vector4 arm; // Body-local grabbed position
-	int bodyId; // Id of body grabbed
+	BodyId bodyId; // Id of body grabbed
 	DemoUtils::ControlInfo controlInfo; // 
 	std::shared_ptr<physicsWorld> world; // Physics world simulating the body
 };
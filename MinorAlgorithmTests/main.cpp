@@ -188,6 +188,53 @@ void transformsTest()
 	}
 }
 
+#include <physicsWorld.h>
+#include <physicsFrameArena.h>
+#include <DemoUtils.h>
+
+// Once a world has settled, stepping it must not allocate, see physicsAllocationCounter
+void steadyStepAllocationTest()
+{
+	if ( !physicsAllocationCounter::isCounting() )
+	{
+		return;
+	}
+
+	const physicsSolverType solverTypes[] =
+	{
+		physicsSolverType::SEQUENTIAL,
+		physicsSolverType::SIMD,
+		physicsSolverType::PARALLEL,
+		physicsSolverType::JACOBI
+	};
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		physicsWorldConfig config;
+		config.m_solverType = solverTypes[i];
+		config.m_numThreads = 4;
+		config.m_allowSleeping = false; // Sleeping islands would skip the work
+
+		std::shared_ptr<physicsWorld> world = std::make_shared<physicsWorld>( config );
+		DemoUtils::createWalls( world );
+		DemoUtils::createPackedCircles( world, Vector4( 512.f, 200.f ), 10.f, 20 );
+
+		for ( int j = 0; j < 100; j++ )
+		{
+			world->step();
+		}
+
+		const long long numAllocations = physicsAllocationCounter::getNumAllocations();
+
+		for ( int j = 0; j < 1000; j++ )
+		{
+			world->step();
+		}
+
+		Assert( physicsAllocationCounter::getNumAllocations() == numAllocations, "steady step allocated" );
+	}
+}
+
 int main( int argc, char* argv[] )
 {
 	classifySetsTest();
@@ -196,6 +243,8 @@ int main( int argc, char* argv[] )
 
 	transformsTest();
 
+	steadyStepAllocationTest();
+
 	__debugbreak();
 
 	return 0;
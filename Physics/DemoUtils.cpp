@@ -8,7 +8,7 @@ void DemoUtils::grab( ControlInfo& controlInfo, std::shared_ptr<physicsWorld>& w
 {
 	// Grab bodies by attaching a dummy body to it using a joint constraint
 	if ( controlInfo.dummyBodyId == invalidId &&
-		 controlInfo.dummyJointId == invalidId )
+		 controlInfo.dummyJointId == invalidJointId )
 	{
 		physicsBodyCinfo cinfo;
 		{
@@ -39,7 +39,7 @@ void DemoUtils::release( ControlInfo& controlInfo, std::shared_ptr<physicsWorld>
 	world->removeJoint( controlInfo.dummyJointId );
 
 	controlInfo.dummyBodyId = invalidId;
-	controlInfo.dummyJointId = invalidId;
+	controlInfo.dummyJointId = invalidJointId;
 }
 
 void DemoUtils::createPackedCircles( std::shared_ptr<physicsWorld>& world,
@@ -52,6 +52,10 @@ void DemoUtils::createPackedCircles( std::shared_ptr<physicsWorld>& world,
 	Real angle = 0.0f;
 	int limitLayer = 1;
 
+	// Circles share one shape and are created together
+	std::shared_ptr<physicsShape> shape = physicsCircleShape::create( radius );
+	std::vector<physicsBodyCinfo> cinfos( numCircles );
+
 	for ( int i = 0, j = 0; i < numCircles; i++, j++ )
 	{
 		if ( j == limitLayer )
@@ -63,15 +67,16 @@ void DemoUtils::createPackedCircles( std::shared_ptr<physicsWorld>& world,
 			j = 0;
 		}
 
-		physicsBodyCinfo cinfo;
+		physicsBodyCinfo& cinfo = cinfos[i];
 		{
-			cinfo.m_shape = physicsCircleShape::create( radius );
+			cinfo.m_shape = shape;
 			Vector4 buf; buf.setRotatedDir( arm, angle*j );
 			cinfo.m_pos = buf + pos;
 		}
-
-		world->createBody( cinfo );
 	}
+
+	std::vector<BodyId> bodyIds;
+	world->createBodies( cinfos, bodyIds );
 }
 
 void DemoUtils::createWalls( std::shared_ptr<physicsWorld>& world )
@@ -140,7 +145,7 @@ void DemoUtils::createWalls( std::shared_ptr<physicsWorld>& world )
 
 void DemoUtils::createConstrainedBodies( std::shared_ptr<physicsWorld>& world )
 {
-	int bIdA, bIdB;
+	BodyId bIdA, bIdB;
 	{
 		physicsBodyCinfo cinfo;
 		std::vector<Vector4> vertices;
@@ -16,7 +16,7 @@ namespace DemoUtils
 		ControlInfo()
 		{
 			dummyBodyId = invalidId;
-			dummyJointId = invalidId;
+			dummyJointId = invalidJointId;
 		}
 	};
 
@@ -2,7 +2,6 @@
 
 #include <physicsTypes.h>
 #include <physicsBody.h>
-#include <physicsObject.h>
 #include <physicsSolver.h>
 
 #include <Renderer.h>
@@ -21,6 +20,7 @@ physicsBodyCinfo::physicsBodyCinfo()
 	m_angularSpeed = 0.f;
 	m_mass = -1.f;
 	m_inertia = -1.f;
+	m_friction = 0.5f;
 	m_collidable = true;
 }
 
@@ -29,99 +29,279 @@ physicsBodyCinfo::~physicsBodyCinfo()
 
 }
 
-physicsBody::physicsBody( const physicsBodyCinfo& bodyCinfo ) :
-	m_name( bodyCinfo.m_name ),
-	m_bodyId( invalidId ),
-	m_shape( bodyCinfo.m_shape ),
-	m_motionType( bodyCinfo.m_motionType ),
-	m_pos( bodyCinfo.m_pos ),
-	m_ori( bodyCinfo.m_ori ),
-	m_linearVelocity( bodyCinfo.m_linearVelocity ),
-	m_angularSpeed( bodyCinfo.m_angularSpeed ),
-	m_mass( bodyCinfo.m_mass ),
-	m_inertia( bodyCinfo.m_inertia )
+//
+// physicsBodyStorage class non-inline functions
+physicsBodyStorage::physicsBodyStorage() :
+	m_firstFreeSlot( -1 )
 {
 
+}
+
+BodyId physicsBodyStorage::add( const physicsBodyCinfo& bodyCinfo )
+{
+	return set( allocateSlot(), bodyCinfo );
+}
+
+void physicsBodyStorage::add( const std::vector<physicsBodyCinfo>& bodyCinfos, std::vector<BodyId>& bodyIdsOut )
+{
+	reserve( getNumSlots() + ( int )bodyCinfos.size() );
+	bodyIdsOut.reserve( bodyIdsOut.size() + bodyCinfos.size() );
+
+	for ( auto iter = bodyCinfos.begin(); iter != bodyCinfos.end(); iter++ )
+	{
+		bodyIdsOut.push_back( set( allocateSlot(), *iter ) );
+	}
+}
+
+void physicsBodyStorage::remove( BodyId bodyId )
+{
+	Assert( isValid( bodyId ), "removing invalid body" );
+
+	const int bodyIdx = getBodyIdx( bodyId );
+
+	// Registered shape stays, other bodies may share it
+	m_shapeIds[bodyIdx] = invalidShapeId;
+
+	// Add removed body's slot to free slot linked list
+	physicsBodyState& state = m_states[bodyIdx];
+	state.isFree = true;
+	state.generation = ( state.generation + 1 ) & ( invalidId >> g_bodyIdxBits );
+	state.nextSleepingBodyId = ( m_firstFreeSlot < 0 ) ? invalidId : ( BodyId )m_firstFreeSlot;
+	m_firstFreeSlot = bodyIdx;
+}
+
+void physicsBodyStorage::reserve( int numSlots )
+{
+	m_positions.reserve( numSlots );
+	m_rotations.reserve( numSlots );
+	m_rotationCosSins.reserve( numSlots );
+	m_linearVelocities.reserve( numSlots );
+	m_angularSpeeds.reserve( numSlots );
+	m_invMasses.reserve( numSlots );
+	m_invInertias.reserve( numSlots );
+	m_aabbs.reserve( numSlots );
+	m_shapeIds.reserve( numSlots );
+	m_states.reserve( numSlots );
+	m_coldData.reserve( numSlots );
+}
+
+int physicsBodyStorage::allocateSlot()
+{
+	if ( m_firstFreeSlot >= 0 )
+	{
+		// Re-use slot of a removed body, its generation was bumped on removal
+		const int bodyIdx = m_firstFreeSlot;
+		m_firstFreeSlot = ( m_states[bodyIdx].nextSleepingBodyId == invalidId ) ? -1 : ( int )m_states[bodyIdx].nextSleepingBodyId;
+		return bodyIdx;
+	}
+
+	// Append on back
+	const int bodyIdx = ( int )m_states.size();
+	Assert( bodyIdx < ( int )g_bodyIdxMask, "too many bodies" );
+
+	m_positions.push_back( Vector4() );
+	m_rotations.push_back( 0.f );
+	m_rotationCosSins.push_back( Rotation() );
+	m_linearVelocities.push_back( Vector4() );
+	m_angularSpeeds.push_back( 0.f );
+	m_invMasses.push_back( 0.f );
+	m_invInertias.push_back( 0.f );
+	m_aabbs.push_back( physicsAabb() );
+	m_shapeIds.push_back( invalidShapeId );
+	m_states.push_back( physicsBodyState() );
+	m_coldData.push_back( physicsBodyColdData() );
+
+	m_states.back().generation = 0;
+
+	return bodyIdx;
+}
+
+BodyId physicsBodyStorage::set( int bodyIdx, const physicsBodyCinfo& bodyCinfo )
+{
+	const ShapeId shapeId = m_shapes.intern( *bodyCinfo.m_shape );
+
+	m_positions[bodyIdx] = bodyCinfo.m_pos;
+	m_rotations[bodyIdx] = bodyCinfo.m_ori;
+	m_rotationCosSins[bodyIdx].set( bodyCinfo.m_ori );
+	m_linearVelocities[bodyIdx] = bodyCinfo.m_linearVelocity;
+	m_angularSpeeds[bodyIdx] = bodyCinfo.m_angularSpeed;
+	m_shapeIds[bodyIdx] = shapeId;
+
+	physicsBodyState& state = m_states[bodyIdx];
+	state.motionType = bodyCinfo.m_motionType;
+	state.isSleeping = false;
+	state.collisionFilter = ( bodyCinfo.m_collidable ) ? 0 : 1;
+	state.activeListIdx = 0;
+	state.sleepTime = 0.f;
+	state.nextSleepingBodyId = invalidId;
+	state.isFree = false;
+
+	physicsBodyColdData& coldData = m_coldData[bodyIdx];
+	coldData.name = bodyCinfo.m_name;
+	coldData.mass = bodyCinfo.m_mass;
+	coldData.inertia = bodyCinfo.m_inertia;
+	coldData.friction = bodyCinfo.m_friction;
+
 	if ( bodyCinfo.m_motionType == physicsMotionType::DYNAMIC )
 	{
 		// Set up mass and inertia if not set (recommended way)
+		const physicsShapeProperties& shapeProperties = m_shapes.getProperties( shapeId );
+
 		if ( bodyCinfo.m_mass < 0.f )
 		{
-			m_mass = m_shape->calculateMass();
+			coldData.mass = shapeProperties.mass;
 		}
 
 		if ( bodyCinfo.m_inertia < 0.f )
 		{
-			m_inertia = m_shape->calculateInertia();
+			coldData.inertia = shapeProperties.inertia;
 		}
 
-		m_invMass = 1.f / m_mass;
-		m_invInertia = 1.f / m_inertia;
+		m_invMasses[bodyIdx] = 1.f / coldData.mass;
+		m_invInertias[bodyIdx] = 1.f / coldData.inertia;
 	}
 	else if ( bodyCinfo.m_motionType == physicsMotionType::STATIC )
 	{
-		Assert( m_mass < 0.f, "Mass shouldn't have been set for static bodies." );
-		Assert( m_inertia < 0.f, "Inertia shouldn't have been set for static bodies" );
-		m_invMass = 0.f;
-		m_invInertia = 0.f;
+		Assert( bodyCinfo.m_mass < 0.f, "Mass shouldn't have been set for static bodies." );
+		Assert( bodyCinfo.m_inertia < 0.f, "Inertia shouldn't have been set for static bodies" );
+		m_invMasses[bodyIdx] = 0.f;
+		m_invInertias[bodyIdx] = 0.f;
 	}
 	else
 	{
 		Assert( false, "Trying to construct invalid body type." );
 	}
 
-	m_collisionFilter = ( bodyCinfo.m_collidable ) ? 0 : 1;
+	return ( BodyId )bodyIdx | ( state.generation << g_bodyIdxBits );
 }
 
-physicsBody::~physicsBody()
+void physicsBodyStorage::clear()
 {
-
+	m_positions.clear();
+	m_rotations.clear();
+	m_rotationCosSins.clear();
+	m_linearVelocities.clear();
+	m_angularSpeeds.clear();
+	m_invMasses.clear();
+	m_invInertias.clear();
+	m_aabbs.clear();
+	m_shapeIds.clear();
+	m_shapes = physicsShapeRegistry();
+	m_states.clear();
+	m_coldData.clear();
+	m_firstFreeSlot = -1;
 }
 
-bool physicsBody::containsPoint( const Vector4& point ) const
+//#define PREDICTIVE_C
+void physicsBodyStorage::updateAabbs( const std::vector<BodyId>& bodyIds )
 {
-	// Convert point: world->local
-	Vector4 local;
-	local.setSub( point, m_pos );
-	local.setRotatedDir( local, -m_ori );
+	for ( int i = 0; i < ( int )bodyIds.size(); i++ )
+	{
+		const int bodyIdx = getBodyIdx( bodyIds[i] );
 
-	return m_shape->containsPoint( local );
-}
+		if ( m_states[bodyIdx].isSleeping )
+		{
+			continue;
+		}
 
-//#define PREDICTIVE_C
-void physicsBody::updateAabb()
-{
-	m_aabb = m_shape->getAabb( m_ori );
+		// TODO: only update if aabb is dirty, don't update for static bodies
+		physicsAabb& aabb = m_aabbs[bodyIdx];
+		const ShapeId shapeId = m_shapeIds[bodyIdx];
+
+		// Switch on type kept in shape id, aabb of concrete shape type is called directly
+		switch ( physicsShapeRegistry::getType( shapeId ) )
+		{
+		case physicsShape::CIRCLE:
+			// Circle's aabb doesn't depend on rotation, take the one cached on registration
+			aabb = m_shapes.getProperties( shapeId ).localAabb;
+			break;
+		case physicsShape::BOX:
+			aabb = m_shapes.getTypedShape<physicsBoxShape>( shapeId ).getAabb( m_rotationCosSins[bodyIdx] );
+			break;
+		case physicsShape::CONVEX:
+			aabb = m_shapes.getTypedShape<physicsConvexShape>( shapeId ).getAabb( m_rotationCosSins[bodyIdx] );
+			break;
+		default:
+			Assert( false, "body has invalid shape" );
+			break;
+		}
 #if defined PREDICTIVE_C
-	m_aabb.expand( m_linearVelocity );
+		aabb.expand( m_linearVelocities[bodyIdx] );
 #else
-	m_aabb.expand( 0.5f );
+		aabb.expand( 0.5f );
 #endif
-	m_aabb.translate( m_pos );
+		aabb.translate( m_positions[bodyIdx] );
+	}
 }
 
-void physicsBody::getPointVelocity( const Vector4& arm, Vector4& vel ) const
+void physicsBodyStorage::applyGravity( const std::vector<BodyId>& bodyIds, const Vector4& deltaVelocity )
 {
-	// TODO: Test
-	Vector4 w( 0.f, 0.f, m_angularSpeed );
-	Vector4 tangentVel = w.cross( arm.getRotatedDir( m_ori ) );
-	vel = tangentVel + m_linearVelocity;
+	for ( int i = 0; i < ( int )bodyIds.size(); i++ )
+	{
+		const BodyId bodyId = bodyIds[i];
+
+		if ( isSimulated( bodyId ) )
+		{
+			m_linearVelocities[getBodyIdx( bodyId )] += deltaVelocity;
+		}
+	}
 }
 
-void physicsBody::setDampedVelocity( const Real& damping )
+void physicsBodyStorage::getSolverBodies( const BodyId* bodyIds, int numBodies, SolverBody* solverBodiesOut ) const
 {
-	// Example of damping would be 0.95f;
-	setLinearVelocity( getLinearVelocity() * damping );
-	setAngularSpeed( getAngularSpeed() * damping );
+	for ( int i = 0; i < numBodies; i++ )
+	{
+		const int bodyIdx = getBodyIdx( bodyIds[i] );
+		SolverBody& solverBody = solverBodiesOut[i];
+
+		solverBody.v = m_linearVelocities[bodyIdx];
+		solverBody.w.setZero();
+		solverBody.w( 2 ) = m_angularSpeeds[bodyIdx];
+		solverBody.dp.setZero();
+		solverBody.dRot = 0.f;
+		solverBody.mInv = m_invMasses[bodyIdx];
+		solverBody.iInv = m_invInertias[bodyIdx];
+	}
+}
+
+void physicsBodyStorage::integrate( const BodyId* bodyIds, int numBodies, const SolverBody* solverBodies,
+									const Real deltaTime, const bool substepped )
+{
+	// Without substeps deltas hold split impulse correction, zero without it
+	const Real velocityTime = substepped ? 0.f : deltaTime;
+
+	for ( int i = 0; i < numBodies; i++ )
+	{
+		const int bodyIdx = getBodyIdx( bodyIds[i] );
+		const SolverBody& solverBody = solverBodies[i];
+
+		m_linearVelocities[bodyIdx] = solverBody.v;
+		m_angularSpeeds[bodyIdx] = solverBody.w( 2 );
+
+		m_positions[bodyIdx] += solverBody.v * velocityTime + solverBody.dp;
+		// Cos and sin follow by the same angle, renormalized instead of evaluating trig
+		const Real deltaRotation = solverBody.w( 2 ) * velocityTime + solverBody.dRot;
+		m_rotations[bodyIdx] += deltaRotation;
+		m_rotationCosSins[bodyIdx].integrate( deltaRotation );
+	}
 }
 
-physicsShape::Type physicsBody::getShapeType() const
+//
+// physicsBody class non-inline functions
+bool physicsBody::containsPoint( const Vector4& point ) const
 {
-	return m_shape->getType();
+	// Convert point: world->local
+	Vector4 local;
+	local.setSub( point, getPosition() );
+	local.setInverseRotatedDir( local, getRotationCosSin() );
+
+	return getShape()->containsPoint( local );
 }
 
-void physicsBody::setFromSolverBody( const SolverBody& body )
+void physicsBody::getPointVelocity( const Vector4& arm, Vector4& vel ) const
 {
-	setLinearVelocity( body.v );
-	setAngularSpeed( body.w( 2 ) );
-}
\ No newline at end of file
+	// TODO: Test
+	Vector4 w( 0.f, 0.f, getAngularSpeed() );
+	Vector4 tangentVel = w.cross( arm.getRotatedDir( getRotationCosSin() ) );
+	vel = tangentVel + getLinearVelocity();
+}
@@ -1,11 +1,12 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
-#include <physicsObject.h>
 #include <physicsTypes.h>
 #include <physicsAabb.h>
 #include <physicsShape.h>
+#include <physicsShapeRegistry.h>
 
 enum class physicsMotionType
 {
@@ -24,7 +25,7 @@ public:
 public:
 
 	std::string m_name;
-	std::shared_ptr<physicsShape> m_shape;
+	std::shared_ptr<physicsShape> m_shape; // Copied into world's shape registry, not kept
 	physicsMotionType m_motionType;
 	Vector4 m_pos;
     Real m_ori;
@@ -37,106 +38,193 @@ public:
 	bool m_collidable;
 };
 
-struct FreeBody
+class physicsBody;
+struct SolverBody;
+
+// Per body flags and sleep bookkeeping, read by most passes deciding whether a body takes part
+struct physicsBodyState
+{
+	physicsMotionType motionType;
+	bool isSleeping;
+	unsigned int collisionFilter;
+	unsigned int activeListIdx; // Index of this body in physicsWorld::m_activeBodyIds
+	Real sleepTime; // Time spent below sleep velocities
+	BodyId nextSleepingBodyId; // Bodies of a sleeping island form a ring, so waking one wakes all
+
+	// Slot bookkeeping, free slots link to the next free slot index through nextSleepingBodyId
+	bool isFree;
+	BodyId generation; // Bumped on removal, wraps within the handle's generation bits
+};
+
+// Body data which is only read when creating contacts or by queries
+struct physicsBodyColdData
 {
-	int m_nextFreeBodyIdx;
+	std::string name;
+	Real mass;
+	Real inertia;
+	Real friction;
 };
 
-// Physical body which allows accessing read-only parameters
-// Changes should be only done internally by the world
-class physicsBody : public physicsObject
+// Bodies of a world stored as separate arrays indexed by body slot index
+// Each pass over bodies (aabb update, solver setup, integration) streams through only the arrays it needs
+// Handles stay valid while other bodies come and go, a removed body's handle is rejected
+// even after its slot is re-used
+class physicsBodyStorage
 {
 public:
 
-    physicsBody(const physicsBodyCinfo& bodyCinfo);
+	physicsBodyStorage();
 
-    ~physicsBody();
+	// Slots of removed bodies are re-used
+	BodyId add( const physicsBodyCinfo& cinfo );
 
-	const std::string& getName() const { return m_name; }
-	void setName( const std::string& name ) { m_name = name; }
+	// Add bodies in order of cinfos, appending their ids to bodyIdsOut
+	void add( const std::vector<physicsBodyCinfo>& cinfos, std::vector<BodyId>& bodyIdsOut );
 
-	unsigned int getBodyId() const { return m_bodyId; }
+	void remove( BodyId bodyId );
+	void clear();
 
-	// Return read-only access to shape
-	inline const physicsShape* getShape() const;
+	inline bool isValid( BodyId bodyId ) const;
 
-	physicsMotionType getMotionType() const { return m_motionType; }
-	inline bool isStatic() const;
+	// Arrays indexed by slot index are this long, removed bodies included
+	int getNumSlots() const { return ( int )m_states.size(); }
 
-	// Read-only access to transforms and motion
-	const Vector4& getPosition() const { return m_pos; }
-	const Real getRotation() const { return  m_ori; }
-	const Vector4& getLinearVelocity() const { return m_linearVelocity; }
-	const Real getAngularSpeed() const { return m_angularSpeed; }
+	inline physicsBody getBody( BodyId bodyId ) const;
 
-	const Real getMass() const { return m_mass; }
-	const Real getInertia() const { return m_inertia; }
-	const Real getInvMass() const { return m_invMass; }
-	const Real getInvInertia() const { return m_invInertia; }
+	inline bool isStatic( BodyId bodyId ) const;
+	inline bool isSleeping( BodyId bodyId ) const;
 
-	bool containsPoint( const Vector4& point ) const;
+	// Non-static body which is awake
+	inline bool isSimulated( BodyId bodyId ) const;
 
 private:
 
-	std::string m_name;
-	BodyId m_bodyId;
-	std::shared_ptr<physicsShape> m_shape;
-	physicsMotionType m_motionType;
-	Vector4 m_pos;
-	Real m_ori;
-	Vector4 m_linearVelocity;
-	Real m_angularSpeed; // in radians
-	Real m_mass;
-	Real m_inertia;
+	void reserve( int numSlots );
 
-private:
+	// Take a free slot or append one, returns slot index
+	int allocateSlot();
+
+	// Registered shape's mass and inertia are used where cinfo leaves them unset, returns body id
+	BodyId set( int bodyIdx, const physicsBodyCinfo& cinfo );
 
 	// These functions are used internally in physicsWorld
 
-	inline void setBodyId( unsigned int bodyId );
+	// Streaming passes over given bodies
 
-	physicsShape::Type getShapeType() const;
+	// Sleeping bodies keep their aabb from when they fell asleep
+	void updateAabbs( const std::vector<BodyId>& bodyIds );
 
-	// Internal usage - aabb
-	inline physicsAabb getAabb() const;
-	void updateAabb();
+	void applyGravity( const std::vector<BodyId>& bodyIds, const Vector4& deltaVelocity );
 
-	// Internal usage - motion type
-	inline void setMotionType( physicsMotionType type );
+	// Solver bodies are written in order of bodyIds
+	void getSolverBodies( const BodyId* bodyIds, int numBodies, SolverBody* solverBodiesOut ) const;
 
-	// Internal usage - position, rotation, linear velocity, angular speed
-	inline void setPosition( const Vector4& pos );
-	inline void setRotation( const Real rotation );
-	inline void setLinearVelocity( const Vector4& linearVel );
-	inline void setAngularSpeed( const Real angularVel );
+	// Take velocities of solver bodies given in order of bodyIds and move bodies over the step
+	// Substepped solver bodies were already moved, their deltas hold the whole step's motion
+	void integrate( const BodyId* bodyIds, int numBodies, const SolverBody* solverBodies,
+					const Real deltaTime, const bool substepped );
 
-	void getPointVelocity( const Vector4& arm, Vector4& vel ) const; // arm is local
-	void setDampedVelocity( const Real& damping );
+	// Internal usage - motion type
+	inline void setMotionType( BodyId bodyId, physicsMotionType type );
 
-	// Internal usage - mass, inertia, COM
-	inline void setMass(const Real mass);
-	inline void setInertia( const Real inertia );
+	inline void setPosition( BodyId bodyId, const Vector4& pos );
 
-	// Internal usage - indices
-	inline void setActiveListIdx( unsigned int idx );
-	inline unsigned int getActiveListIdx() const;
+	// Internal usage - sleeping
+	inline void setSleeping( BodyId bodyId, bool sleeping );
+	inline Real getSleepTime( BodyId bodyId ) const;
+	inline void setSleepTime( BodyId bodyId, const Real sleepTime );
+	inline BodyId getNextSleepingBodyId( BodyId bodyId ) const;
+	inline void setNextSleepingBodyId( BodyId bodyId, BodyId nextBodyId );
 
-	// Internal usage - collision filter
-	inline unsigned int getCollisionFilter() const;
+	// Internal usage - indices
+	inline void setActiveListIdx( BodyId bodyId, unsigned int idx );
+	inline unsigned int getActiveListIdx( BodyId bodyId ) const;
 
-	// Used by world to update body from solver bodies
-	void setFromSolverBody( const struct SolverBody& body );
+	inline unsigned int getCollisionFilter( BodyId bodyId ) const;
+	inline physicsShape::Type getShapeType( BodyId bodyId ) const;
+	inline const physicsAabb& getAabb( BodyId bodyId ) const;
 
 private:
 
-	physicsAabb m_aabb;
-	Real m_invMass;
-	Real m_invInertia;
-	unsigned int m_activeListIdx; // Index of this body in physicsWorld::m_activeBodyIds
-	unsigned int m_collisionFilter;
+	// Hot data, touched by every step
+	std::vector<Vector4> m_positions;
+	std::vector<Real> m_rotations; // in radians, not wrapped
+	std::vector<Rotation> m_rotationCosSins; // Same rotations as cos and sin, for rotating without trig
+	std::vector<Vector4> m_linearVelocities;
+	std::vector<Real> m_angularSpeeds; // in radians
+	std::vector<Real> m_invMasses;
+	std::vector<Real> m_invInertias;
+	std::vector<physicsAabb> m_aabbs;
+	std::vector<ShapeId> m_shapeIds;
+	std::vector<physicsBodyState> m_states;
+
+	std::vector<physicsBodyColdData> m_coldData;
+
+	int m_firstFreeSlot; // -1 when no slot is free
 
+	// Bodies with equal shapes share one registered shape
+	physicsShapeRegistry m_shapes;
+
+	friend class physicsBody;
 	friend class physicsWorld;
 	friend class physicsWorldEx;
 };
 
+// Read-only view of a body in physicsBodyStorage, cheap to copy
+// Changes should be only done internally by the world, a view is not kept over removing its body
+class physicsBody
+{
+public:
+
+	physicsBody( const physicsBodyStorage* storage, BodyId bodyId ) :
+		m_storage( storage ), m_bodyId( bodyId ), m_bodyIdx( getBodyIdx( bodyId ) ) {}
+
+	const std::string& getName() const { return m_storage->m_coldData[m_bodyIdx].name; }
+
+	BodyId getBodyId() const { return m_bodyId; }
+
+	// Return read-only access to shape, shared with bodies made from equal shapes
+	inline const physicsShape* getShape() const;
+
+	ShapeId getShapeId() const { return m_storage->m_shapeIds[m_bodyIdx]; }
+
+	physicsMotionType getMotionType() const { return m_storage->m_states[m_bodyIdx].motionType; }
+	bool isStatic() const { return m_storage->isStatic( m_bodyId ); }
+
+	// Sleeping bodies are skipped by narrowphase, solver and integration until woken
+	bool isSleeping() const { return m_storage->isSleeping( m_bodyId ); }
+
+	// Non-static body which is awake
+	bool isSimulated() const { return m_storage->isSimulated( m_bodyId ); }
+
+	// Read-only access to transforms and motion
+	const Vector4& getPosition() const { return m_storage->m_positions[m_bodyIdx]; }
+	const Real getRotation() const { return m_storage->m_rotations[m_bodyIdx]; }
+	const Rotation& getRotationCosSin() const { return m_storage->m_rotationCosSins[m_bodyIdx]; }
+
+	// Transform built from stored cos and sin
+	Transform getTransform() const { return Transform( getPosition(), getRotation(), getRotationCosSin() ); }
+	const Vector4& getLinearVelocity() const { return m_storage->m_linearVelocities[m_bodyIdx]; }
+	const Real getAngularSpeed() const { return m_storage->m_angularSpeeds[m_bodyIdx]; }
+
+	const Real getMass() const { return m_storage->m_coldData[m_bodyIdx].mass; }
+	const Real getInertia() const { return m_storage->m_coldData[m_bodyIdx].inertia; }
+	const Real getInvMass() const { return m_storage->m_invMasses[m_bodyIdx]; }
+	const Real getInvInertia() const { return m_storage->m_invInertias[m_bodyIdx]; }
+
+	const Real getFriction() const { return m_storage->m_coldData[m_bodyIdx].friction; }
+
+	const physicsAabb& getAabb() const { return m_storage->m_aabbs[m_bodyIdx]; }
+
+	bool containsPoint( const Vector4& point ) const;
+
+	void getPointVelocity( const Vector4& arm, Vector4& vel ) const; // arm is local
+
+private:
+
+	const physicsBodyStorage* m_storage;
+	BodyId m_bodyId;
+	int m_bodyIdx;
+};
+
 #include <physicsBody.inl>
@@ -1,77 +1,115 @@
-inline const physicsShape* physicsBody::getShape() const
+//
+// physicsBodyStorage inline functions
+inline physicsBody physicsBodyStorage::getBody( BodyId bodyId ) const
+{
+	Assert( isValid( bodyId ), "invalid body" );
+	return physicsBody( this, bodyId );
+}
+
+inline bool physicsBodyStorage::isValid( BodyId bodyId ) const
 {
-	return m_shape.get();
+	const int bodyIdx = getBodyIdx( bodyId );
+
+	return ( bodyIdx < ( int )m_states.size() &&
+			 !m_states[bodyIdx].isFree &&
+			 m_states[bodyIdx].generation == ( bodyId >> g_bodyIdxBits ) );
 }
 
-inline void physicsBody::setMotionType(physicsMotionType type)
+inline bool physicsBodyStorage::isStatic( BodyId bodyId ) const
 {
-	m_motionType = type;
+	return ( m_states[getBodyIdx( bodyId )].motionType == physicsMotionType::STATIC );
+}
 
-	if (m_motionType == physicsMotionType::STATIC)
+inline bool physicsBodyStorage::isSleeping( BodyId bodyId ) const
+{
+	return m_states[getBodyIdx( bodyId )].isSleeping;
+}
+
+inline bool physicsBodyStorage::isSimulated( BodyId bodyId ) const
+{
+	return ( !isStatic( bodyId ) && !isSleeping( bodyId ) );
+}
+
+inline void physicsBodyStorage::setMotionType( BodyId bodyId, physicsMotionType type )
+{
+	m_states[getBodyIdx( bodyId )].motionType = type;
+
+	if ( type == physicsMotionType::STATIC )
 	{
-		m_linearVelocity.setZero();
-		m_angularSpeed = 0.f;
+		m_linearVelocities[getBodyIdx( bodyId )].setZero();
+		m_angularSpeeds[getBodyIdx( bodyId )] = 0.f;
 	}
 }
 
-inline bool physicsBody::isStatic() const
+inline void physicsBodyStorage::setPosition( BodyId bodyId, const Vector4& pos )
 {
-	return (m_motionType == physicsMotionType::STATIC);
+	m_positions[getBodyIdx( bodyId )] = pos;
 }
 
-inline void physicsBody::setPosition(const Vector4& pos)
+inline void physicsBodyStorage::setSleeping( BodyId bodyId, bool sleeping )
 {
-	m_pos = pos;
+	physicsBodyState& state = m_states[getBodyIdx( bodyId )];
+	state.isSleeping = sleeping;
+
+	if ( sleeping )
+	{
+		m_linearVelocities[getBodyIdx( bodyId )].setZero();
+		m_angularSpeeds[getBodyIdx( bodyId )] = 0.f;
+	}
+	else
+	{
+		state.nextSleepingBodyId = invalidId;
+	}
 }
 
-inline void physicsBody::setRotation(const Real rotation)
+inline Real physicsBodyStorage::getSleepTime( BodyId bodyId ) const
 {
-	m_ori = rotation;
+	return m_states[getBodyIdx( bodyId )].sleepTime;
 }
 
-inline void physicsBody::setLinearVelocity(const Vector4& linearVel)
+inline void physicsBodyStorage::setSleepTime( BodyId bodyId, const Real sleepTime )
 {
-	m_linearVelocity = linearVel;
+	m_states[getBodyIdx( bodyId )].sleepTime = sleepTime;
 }
 
-inline void physicsBody::setAngularSpeed(const Real angularVel)
+inline BodyId physicsBodyStorage::getNextSleepingBodyId( BodyId bodyId ) const
 {
-	m_angularSpeed = angularVel;
+	return m_states[getBodyIdx( bodyId )].nextSleepingBodyId;
 }
 
-inline void physicsBody::setMass(const Real mass)
+inline void physicsBodyStorage::setNextSleepingBodyId( BodyId bodyId, BodyId nextBodyId )
 {
-	m_mass = mass;
-	m_invMass = 1.f / m_mass;
+	m_states[getBodyIdx( bodyId )].nextSleepingBodyId = nextBodyId;
 }
 
-inline void physicsBody::setInertia(const Real inertia)
+inline void physicsBodyStorage::setActiveListIdx( BodyId bodyId, unsigned int idx )
 {
-	m_inertia = inertia;
-	m_invInertia = 1.f / m_inertia;
+	m_states[getBodyIdx( bodyId )].activeListIdx = idx;
 }
 
-inline physicsAabb physicsBody::getAabb() const
+inline unsigned int physicsBodyStorage::getActiveListIdx( BodyId bodyId ) const
 {
-	return m_aabb;
+	return m_states[getBodyIdx( bodyId )].activeListIdx;
 }
 
-inline void physicsBody::setBodyId(unsigned int bodyId)
+inline unsigned int physicsBodyStorage::getCollisionFilter( BodyId bodyId ) const
 {
-	m_bodyId = bodyId;
+	return m_states[getBodyIdx( bodyId )].collisionFilter;
 }
 
-inline unsigned int physicsBody::getCollisionFilter() const
+inline physicsShape::Type physicsBodyStorage::getShapeType( BodyId bodyId ) const
 {
-	return m_collisionFilter;
+	return physicsShapeRegistry::getType( m_shapeIds[getBodyIdx( bodyId )] );
 }
 
-inline void physicsBody::setActiveListIdx( unsigned int idx )
+inline const physicsAabb& physicsBodyStorage::getAabb( BodyId bodyId ) const
 {
-	m_activeListIdx = idx;
+	return m_aabbs[getBodyIdx( bodyId )];
 }
 
-inline unsigned int physicsBody::getActiveListIdx() const
+//
+// physicsBody inline functions
+inline const physicsShape* physicsBody::getShape() const
 {
-	return m_activeListIdx;
-}
\ No newline at end of file
+	return m_storage->m_shapes.getShape( m_storage->m_shapeIds[m_bodyIdx] );
+}
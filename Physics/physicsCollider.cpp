@@ -1,6 +1,7 @@
 #include <memory>
 #include <cassert>
 #include <iostream>
+#include <algorithm>
 #include <Base.h>
 #include <physicsTypes.h>
 #include <physicsCd.h>
@@ -61,8 +62,8 @@ void physicsCircleCollider::collide( const physicsShape* shapeA,
 
 	Vector4 posA = transformA.getTranslation();
 	Vector4 posB = transformB.getTranslation();
-	Transform rotA; rotA.setRotation( transformA.getRotation() );
-	Transform rotB; rotB.setRotation( transformB.getRotation() );
+	Rotation rotA; transformA.getRotation( rotA );
+	Rotation rotB; transformB.getRotation( rotB );
 
 	Vector4 ab = posB - posA;
 
@@ -94,14 +95,115 @@ void physicsCircleCollider::collide( const physicsShape* shapeA,
 		// TODO: See if we can avoid square rooting
 		norm.normalize<2>();
 
-		Vector4 cpAinA; cpAinA.setTransformedInversePos( rotA, cpA - posA );
-		Vector4 cpBinB; cpBinB.setTransformedInversePos( rotB, cpB - posB );
+		Vector4 cpAinA; cpAinA.setInverseRotatedDir( cpA - posA, rotA );
+		Vector4 cpBinB; cpBinB.setInverseRotatedDir( cpB - posB, rotB );
 		ContactPoint contact( depth, cpAinA, cpBinB, norm ); // AB for separation
+		contact.setFeatures( physicsShape::EDGE_FEATURE, physicsShape::EDGE_FEATURE ); // Circles have a single smooth feature
 
 		contacts.push_back( contact );
 	}
 }
 
+void CirclePairBatch::clear()
+{
+	posAx.clear(); posAy.clear();
+	posBx.clear(); posBy.clear();
+	radiusA.clear(); radiusB.clear();
+	rotationA.clear(); rotationB.clear();
+	numPairs = 0;
+}
+
+void CirclePairBatch::add( const Vector4& posA, const Vector4& posB, const Real radA, const Real radB, const Rotation& rotA, const Rotation& rotB )
+{
+	posAx.push_back( posA( 0 ) ); posAy.push_back( posA( 1 ) );
+	posBx.push_back( posB( 0 ) ); posBy.push_back( posB( 1 ) );
+	radiusA.push_back( radA ); radiusB.push_back( radB );
+	rotationA.push_back( rotA ); rotationB.push_back( rotB );
+	numPairs++;
+}
+
+void CirclePairBatch::pad()
+{
+	// Unit apart with zero radii never touch
+	while ( posAx.size() % WIDTH != 0 )
+	{
+		posAx.push_back( 0.f ); posAy.push_back( 0.f );
+		posBx.push_back( 1.f ); posBy.push_back( 0.f );
+		radiusA.push_back( 0.f ); radiusB.push_back( 0.f );
+		rotationA.push_back( Rotation() ); rotationB.push_back( Rotation() );
+	}
+}
+
+void physicsCircleCollider::collideBatch( CirclePairBatch& batch, ContactPoint* contactsOut, int* numContactsOut )
+{
+	batch.pad();
+
+	const Realx4 zero( 0.f );
+	const Realx4 one( 1.f );
+
+	for ( int i = 0; i < batch.numPairs; i += CirclePairBatch::WIDTH )
+	{
+		const Vec2x4 posA = Vec2x4::load( &batch.posAx[i], &batch.posAy[i] );
+		const Vec2x4 posB = Vec2x4::load( &batch.posBx[i], &batch.posBy[i] );
+		const Realx4 radA = Realx4::load( &batch.radiusA[i] );
+		const Realx4 radB = Realx4::load( &batch.radiusB[i] );
+
+		Vec2x4 ab; ab.setSub( posB, posA );
+		const Realx4 distSq = ab.lengthSquared();
+		const Realx4 radSum = radA + radB;
+
+		// Touching pairs, concentric circles have no normal and are skipped like in collide()
+		const Realx4 touching = ( distSq < radSum * radSum ) & ( distSq > zero );
+		const int touchingMask = touching.getMask();
+
+		const int numLanes = std::min( CirclePairBatch::WIDTH, batch.numPairs - i );
+
+		for ( int lane = 0; lane < numLanes; lane++ )
+		{
+			numContactsOut[i + lane] = 0;
+		}
+
+		if ( touchingMask == 0 )
+		{
+			continue;
+		}
+
+		// Separated lanes divide by one instead of zero, their results are discarded
+		Realx4 len; len.setSelect( touching, distSq, one ); len.setSqrt( len );
+		const Realx4 depth = radSum - len;
+		const Vec2x4 normal( ab.m_x / len, ab.m_y / len );
+
+		// Contact points relative to circle centers, still in world orientation
+		Vec2x4 cpA; cpA.setMul( normal, radA );
+		Vec2x4 cpB; cpB.setMul( normal, -radB );
+
+		Real depths[CirclePairBatch::WIDTH], nx[CirclePairBatch::WIDTH], ny[CirclePairBatch::WIDTH];
+		Real ax[CirclePairBatch::WIDTH], ay[CirclePairBatch::WIDTH], bx[CirclePairBatch::WIDTH], by[CirclePairBatch::WIDTH];
+		depth.store( depths );
+		normal.store( nx, ny );
+		cpA.store( ax, ay );
+		cpB.store( bx, by );
+
+		// Few lanes touch, rotating contacts into body space is left scalar
+		for ( int lane = 0; lane < numLanes; lane++ )
+		{
+			if ( ( touchingMask & ( 1 << lane ) ) == 0 )
+			{
+				continue;
+			}
+
+			Vector4 cpAinA; cpAinA.setInverseRotatedDir( Vector4( ax[lane], ay[lane] ), batch.rotationA[i + lane] );
+			Vector4 cpBinB; cpBinB.setInverseRotatedDir( Vector4( bx[lane], by[lane] ), batch.rotationB[i + lane] );
+
+			ContactPoint contact( depths[lane], cpAinA, cpBinB, Vector4( nx[lane], ny[lane] ) );
+			contact.setFeatures( physicsShape::EDGE_FEATURE, physicsShape::EDGE_FEATURE );
+
+			contactsOut[i + lane] = contact;
+			numContactsOut[i + lane] = 1;
+		}
+	}
+}
+
 // Circle-box collision agent class functions
 physicsCircleBoxCollider::physicsCircleBoxCollider()
 {
@@ -137,24 +239,25 @@ physicsConvexCollider::physicsConvexCollider()
 
 }
 
+template <typename ShapeTypeA, typename ShapeTypeB>
 void physicsConvexCollider::getSimplexVertex( const Vector4& direction,
-											  const physicsShape* shapeA,
-											  const physicsShape* shapeB,
+											  const ShapeTypeA* shapeA,
+											  const ShapeTypeB* shapeB,
 											  const Transform& transformA,
 											  const Transform& transformB,
 											  SimplexVertex& simplexVertex )
 {
-	Transform rotationA, rotationB;
-	rotationA.setRotation( transformA.getRotation() );
-	rotationB.setRotation( transformB.getRotation() );
+	Rotation rotationA, rotationB;
+	transformA.getRotation( rotationA );
+	transformB.getRotation( rotationB );
 
 	Vector4 dirLocalA, dirLocalB;
-	dirLocalA.setTransformedInversePos( rotationA, direction );
-	dirLocalB.setTransformedInversePos( rotationB, direction.getNegated() );
+	dirLocalA.setInverseRotatedDir( direction, rotationA );
+	dirLocalB.setInverseRotatedDir( direction.getNegated(), rotationB );
 
 	Vector4 supportA, supportB;
-	shapeA->getSupportingVertex( dirLocalA, supportA );
-	shapeB->getSupportingVertex( dirLocalB, supportB );
+	shapeA->getSupportingVertex( dirLocalA, supportA, simplexVertex.featureA );
+	shapeB->getSupportingVertex( dirLocalB, supportB, simplexVertex.featureB );
 
 	Assert( supportA.isOk(), "supportA ain't ok" );
 	Assert( supportB.isOk(), "supportB ain't ok" );
@@ -212,13 +315,17 @@ void physicsConvexCollider::getSimplexVertex( const Vector4& direction,
 //     return false;
 // }
 
+template <typename ShapeTypeA, typename ShapeTypeB>
 void physicsConvexCollider::collide(
-	const physicsShape* shapeA,
-	const physicsShape* shapeB,
+	const physicsShape* baseShapeA,
+	const physicsShape* baseShapeB,
 	const Transform& transformA,
 	const Transform& transformB,
 	std::vector<ContactPoint>& contacts )
 {
+	const ShapeTypeA* shapeA = static_cast< const ShapeTypeA* >( baseShapeA );
+	const ShapeTypeB* shapeB = static_cast< const ShapeTypeB* >( baseShapeB );
+
     Vector4 posA = transformA.getTranslation();
     Vector4 posB = transformB.getTranslation();
 
@@ -232,7 +339,9 @@ void physicsConvexCollider::collide(
 	//direction.setNormalized( direction ); // TODO: investigate whether normalization really necessary
 	
 	// [Simplex vertex index][0=simplex, 1=supportA, 2=supportB]
-	Simplex simplex( 3 );
+	// Kept per thread, so steady collision doesn't allocate as polytope expands
+	static thread_local Simplex simplex;
+	simplex.resize( 3 );
 
 //	drawArrow( transformA.getTranslation(), direction, RED );
 	//drawArrow( transformB.getTranslation(), direction.getNegated(), BLUE );
@@ -352,16 +461,12 @@ void physicsConvexCollider::collide(
 
 		if ( closest02.dot<2>( closest02 ) < closest21.dot<2>( closest21 ) )
 		{
-			simplex[1][0] = simplex[2][0];
-			simplex[1][1] = simplex[2][1];
-			simplex[1][2] = simplex[2][2];
+			simplex[1] = simplex[2];
 			direction = closest02;
 		}
 		else
 		{
-			simplex[0][0] = simplex[2][0];
-			simplex[0][1] = simplex[2][1];
-			simplex[0][2] = simplex[2][2];
+			simplex[0] = simplex[2];
 			direction = closest21;
 		}
 #if 0
@@ -419,25 +524,26 @@ void physicsConvexCollider::collide(
 	//DebugUtils::drawContactNormal( pointA, normal );
 #endif
 	
-	Transform rotationA, rotationB;
-	rotationA.setRotation( transformA.getRotation() );
-	rotationB.setRotation( transformB.getRotation() );
+	Rotation rotationA, rotationB;
+	transformA.getRotation( rotationA );
+	transformB.getRotation( rotationB );
 	
-	Vector4 cpInA; cpInA.setTransformedInversePos( rotationA, pointA - posA );
-	Vector4 cpInB; cpInB.setTransformedInversePos( rotationB, pointB - posB );
+	Vector4 cpInA; cpInA.setInverseRotatedDir( pointA - posA, rotationA );
+	Vector4 cpInB; cpInB.setInverseRotatedDir( pointB - posB, rotationB );
 	
+	// Contact lies on features spanned by supports of both ends of closest edge
 	ContactPoint contact( normal.length<2>(), cpInA, cpInB, normal );
+	contact.setFeatures( physicsShape::getSpannedFeatureId( simplex[previousIdx].featureA, simplex[closestIdx].featureA ),
+						 physicsShape::getSpannedFeatureId( simplex[previousIdx].featureB, simplex[closestIdx].featureB ) );
 	
 	contacts.push_back( contact );
 	
 	// Detect planar contacts
-	Transform t;
-	const float pt = 15.f * g_degToRad;
-	t.setRotation( pt );
+	static const Rotation planarRotation( 15.f * g_degToRad );
 
 	Vector4 d1, d2;
-	d1.setTransformedPos( t, closestEdge.normal );
-	d2.setTransformedInversePos( t, closestEdge.normal );
+	d1.setRotatedDir( closestEdge.normal, planarRotation );
+	d2.setInverseRotatedDir( closestEdge.normal, planarRotation );
 	
 	SimplexVertex newSimplexVertex1, newSimplexVertex2;
 	getSimplexVertex( d1, shapeA, shapeB, transformA, transformB, newSimplexVertex1 );
@@ -500,9 +606,10 @@ void physicsConvexCollider::collide(
 	}
 }
 
+template <typename ShapeTypeA, typename ShapeTypeB>
 void physicsConvexCollider::expandingPolytopeAlgorithm(
-	const physicsShape* shapeA,
-	const physicsShape* shapeB,
+	const ShapeTypeA* shapeA,
+	const ShapeTypeB* shapeB,
 	const Transform& transformA,
 	const Transform& transformB,
 	Simplex& simplex,
@@ -566,4 +673,20 @@ void physicsConvexCollider::getClosestEdgeToOrigin( const Simplex& simplex, Simp
 			edge.index = j;
 		}
 	}
-}
\ No newline at end of file
+}
+
+// Pairs of shape types dispatched by the world, both orders as pairs aren't sorted by shape type
+template void physicsConvexCollider::collide<physicsCircleShape, physicsConvexShape>(
+	const physicsShape*, const physicsShape*, const Transform&, const Transform&, std::vector<ContactPoint>& );
+template void physicsConvexCollider::collide<physicsConvexShape, physicsCircleShape>(
+	const physicsShape*, const physicsShape*, const Transform&, const Transform&, std::vector<ContactPoint>& );
+template void physicsConvexCollider::collide<physicsBoxShape, physicsConvexShape>(
+	const physicsShape*, const physicsShape*, const Transform&, const Transform&, std::vector<ContactPoint>& );
+template void physicsConvexCollider::collide<physicsConvexShape, physicsBoxShape>(
+	const physicsShape*, const physicsShape*, const Transform&, const Transform&, std::vector<ContactPoint>& );
+template void physicsConvexCollider::collide<physicsConvexShape, physicsConvexShape>(
+	const physicsShape*, const physicsShape*, const Transform&, const Transform&, std::vector<ContactPoint>& );
+
+// Untyped support mapping for debug drawing
+template void physicsConvexCollider::getSimplexVertex<physicsShape, physicsShape>(
+	const Vector4&, const physicsShape*, const physicsShape*, const Transform&, const Transform&, SimplexVertex& );
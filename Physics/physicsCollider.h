@@ -3,6 +3,7 @@
 #include <Base.h>
 
 #include <physicsObject.h>
+#include <physicsTypes.h>
 
 #include <vector>
 #include <array>
@@ -15,20 +16,27 @@ private:
 	Vector4 m_posA; // Contact on A seen by A
 	Vector4 m_posB; // Contact on B seen by B
 	Vector4 m_norm; // Point from bodyA to bodyB
+	FeatureId m_featureA; // Feature of A which produced contact
+	FeatureId m_featureB; // Feature of B which produced contact
 
 public:
 
 	ContactPoint()
-		: m_depth( 0.f ), m_posA(), m_posB(), m_norm() {}
+		: m_depth( 0.f ), m_posA(), m_posB(), m_norm(), m_featureA( 0 ), m_featureB( 0 ) {}
 
 	ContactPoint( Real depth, const Vector4& posA, const Vector4& posB, const Vector4& norm )
-		: m_depth( depth ), m_posA( posA ), m_posB( posB ), m_norm( norm ) {}
+		: m_depth( depth ), m_posA( posA ), m_posB( posB ), m_norm( norm ), m_featureA( 0 ), m_featureB( 0 ) {}
 
 	inline const Real getDepth() const { return m_depth; }
 	inline const Vector4& getContactA() const { return m_posA; }
 	inline const Vector4& getContactB() const { return m_posB; }
 	inline const Vector4& getNormal() const { return m_norm; }
 
+	inline void setFeatures( const FeatureId featureA, const FeatureId featureB ) { m_featureA = featureA; m_featureB = featureB; }
+
+	// Key identifying the pair of features, stays same while contact persists
+	inline unsigned int getFeatureKey() const { return ( ( unsigned int )m_featureA << 16 ) | m_featureB; }
+
 };
 
 namespace ContactPointUtils
@@ -60,6 +68,28 @@ public:
 						 std::vector<ContactPoint>& contacts );
 };
 
+// Circle-circle pairs as structure of arrays for the batched circle collider
+struct CirclePairBatch
+{
+	// Pairs handled per instruction
+	static const int WIDTH = Vec2x4::WIDTH;
+
+	std::vector<Real> posAx, posAy, posBx, posBy; // World space
+	std::vector<Real> radiusA, radiusB;
+	std::vector<Rotation> rotationA, rotationB;
+	int numPairs;
+
+	CirclePairBatch() : numPairs( 0 ) {}
+
+	// Keeps capacity, so steady steps don't allocate
+	void clear();
+
+	void add( const Vector4& posA, const Vector4& posB, const Real radA, const Real radB, const Rotation& rotA, const Rotation& rotB );
+
+	// Fill arrays with separated pairs up to a multiple of WIDTH
+	void pad();
+};
+
 class physicsCircleCollider : public physicsCollider
 {
 private:
@@ -73,6 +103,10 @@ public:
 						 const Transform& transformA,
 						 const Transform& transformB,
 						 std::vector<ContactPoint>& contacts );
+
+	// Collide all pairs of batch, WIDTH pairs at a time
+	// Each pair gets at most one contact, written to contactsOut at the pair's index
+	static void collideBatch( CirclePairBatch& batch, ContactPoint* contactsOut, int* numContactsOut );
 };
 
 class physicsCircleBoxCollider : public physicsCollider
@@ -111,7 +145,13 @@ class physicsConvexCollider: public physicsCollider
 {
 public:
 	
-	typedef std::array<Vector4, 3> SimplexVertex; // [0] = vertex, [1] = supportA, [2] = supportB
+	// [0] = vertex, [1] = supportA, [2] = supportB
+	struct SimplexVertex : public std::array<Vector4, 3>
+	{
+		FeatureId featureA; // Features of A and B supporting vertex
+		FeatureId featureB;
+	};
+
 	typedef std::vector<SimplexVertex> Simplex;
 
 	struct SimplexEdge
@@ -122,9 +162,11 @@ public:
 	};
 
 	// Finds simplex vertex and it's support vertices local to A
+	// Shape types are concrete shape classes, or physicsShape to dispatch through the vtable
+	template <typename ShapeTypeA, typename ShapeTypeB>
 	static void getSimplexVertex( const Vector4& direction,
-								  const physicsShape* shapeA,
-								  const physicsShape* shapeB,
+								  const ShapeTypeA* shapeA,
+								  const ShapeTypeB* shapeB,
 								  const Transform& transformA,
 								  const Transform& transformB,
 								  SimplexVertex& simplexVert );
@@ -135,8 +177,9 @@ private:
 	physicsConvexCollider();
 
 
-	static void expandingPolytopeAlgorithm( const physicsShape* shapeA,
-											const physicsShape* shapeB,
+	template <typename ShapeTypeA, typename ShapeTypeB>
+	static void expandingPolytopeAlgorithm( const ShapeTypeA* shapeA,
+											const ShapeTypeB* shapeB,
 											const Transform& transformA,
 											const Transform& transformB,
 											Simplex& simplex,
@@ -146,6 +189,9 @@ private:
 
 public:
 
+	// Specialized per pair of shape types, shapes have to be of ShapeTypeA and ShapeTypeB
+	// Instantiated in physicsCollider.cpp for pairs registered by the world
+	template <typename ShapeTypeA, typename ShapeTypeB>
 	static void collide( const physicsShape* shapeA,
 						 const physicsShape* shapeB,
 						 const Transform& transformA,
@@ -0,0 +1,365 @@
+#include <algorithm>
+
+#include <Base.h>
+#include <physicsTypes.h>
+#include <physicsBody.h>
+#include <physicsSolver.h>
+#include <physicsDirectSolver.h>
+
+// Structures kept per solver, i.e. joint islands solved on the same thread before re-building
+const int g_maxCachedStructures = 4;
+
+// Rows whose pivot falls this far below their diagonal are taken as redundant, e.g. closing a loop
+const Real g_directSolverPivotTolerance = 1e-5f;
+
+// Bodies which aren't dynamic don't couple rows, they all look like the static body
+inline int getCouplingBodyIdx( const std::vector<SolverBody>& solverBodies, int bodyIdx )
+{
+	return solverBodies[bodyIdx].isDynamic() ? bodyIdx : SolverBody::STATIC_BODY_IDX;
+}
+
+// Entry of J M^-1 J^T coupling two rows through the bodies they share
+Real calcRowCoupling( const SolverRow& row0, const SolverRow& row1, const std::vector<SolverBody>& solverBodies )
+{
+	const int bodyIdxs0[2] = { row0.bodyIdxA, row0.bodyIdxB };
+	const int bodyIdxs1[2] = { row1.bodyIdxA, row1.bodyIdxB };
+	const Vector4* vs0[2] = { &row0.jac.vA, &row0.jac.vB };
+	const Vector4* vs1[2] = { &row1.jac.vA, &row1.jac.vB };
+	const Real ws0[2] = { row0.jac.wA( 2 ), row0.jac.wB( 2 ) };
+	const Real ws1[2] = { row1.jac.wA( 2 ), row1.jac.wB( 2 ) };
+
+	Real coupling = 0.f;
+
+	for ( int i = 0; i < 2; i++ )
+	{
+		const SolverBody& body = solverBodies[bodyIdxs0[i]];
+
+		if ( !body.isDynamic() )
+		{
+			continue;
+		}
+
+		for ( int j = 0; j < 2; j++ )
+		{
+			if ( bodyIdxs0[i] == bodyIdxs1[j] )
+			{
+				coupling += vs0[i]->dot<2>( *vs1[j] ) * body.mInv + ws0[i] * ws1[j] * body.iInv;
+			}
+		}
+	}
+
+	return coupling;
+}
+
+physicsDirectSolver::physicsDirectSolver() :
+	m_numSolves( 0 )
+{
+
+}
+
+DirectSolverStructure& physicsDirectSolver::findStructure(
+	const std::vector<ConstrainedPair>& constrainedPairs,
+	const std::vector<int>& pairRowOffsets,
+	const std::vector<SolverBody>& solverBodies )
+{
+	m_topology.clear();
+
+	for ( int i = 0; i < ( int )constrainedPairs.size(); i++ )
+	{
+		m_topology.push_back( getCouplingBodyIdx( solverBodies, constrainedPairs[i].solverBodyIdxA ) );
+		m_topology.push_back( getCouplingBodyIdx( solverBodies, constrainedPairs[i].solverBodyIdxB ) );
+		m_topology.push_back( pairRowOffsets[i + 1] - pairRowOffsets[i] );
+	}
+
+	m_numSolves++;
+
+	for ( auto iter = m_structures.begin(); iter != m_structures.end(); iter++ )
+	{
+		if ( iter->topology == m_topology )
+		{
+			iter->lastUsed = m_numSolves;
+			return *iter;
+		}
+	}
+
+	// Replace least recently used structure once the cache is full
+	DirectSolverStructure* structure = nullptr;
+
+	if ( ( int )m_structures.size() < g_maxCachedStructures )
+	{
+		m_structures.push_back( DirectSolverStructure() );
+		structure = &m_structures.back();
+	}
+	else
+	{
+		structure = &*std::min_element( m_structures.begin(), m_structures.end(),
+			[]( const DirectSolverStructure& a, const DirectSolverStructure& b ) { return a.lastUsed < b.lastUsed; } );
+	}
+
+	structure->topology = m_topology;
+	structure->lastUsed = m_numSolves;
+	buildStructure( constrainedPairs, pairRowOffsets, solverBodies, *structure );
+
+	return *structure;
+}
+
+void physicsDirectSolver::buildStructure(
+	const std::vector<ConstrainedPair>& constrainedPairs,
+	const std::vector<int>& pairRowOffsets,
+	const std::vector<SolverBody>& solverBodies,
+	DirectSolverStructure& structureOut )
+{
+	const int numPairs = ( int )constrainedPairs.size();
+	const int numBodies = ( int )solverBodies.size();
+	const int numRows = pairRowOffsets[numPairs];
+
+	// Pairs of each dynamic body, static body couples nothing and gets none
+	std::vector<int> bodyPairOffsets( numBodies + 1, 0 );
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		bodyPairOffsets[m_topology[3 * i] + 1]++;
+		bodyPairOffsets[m_topology[3 * i + 1] + 1]++;
+	}
+
+	bodyPairOffsets[SolverBody::STATIC_BODY_IDX + 1] = 0;
+
+	for ( int i = 0; i < numBodies; i++ )
+	{
+		bodyPairOffsets[i + 1] += bodyPairOffsets[i];
+	}
+
+	std::vector<int> bodyPairs( bodyPairOffsets[numBodies] );
+	std::vector<int> cursor( bodyPairOffsets.begin(), bodyPairOffsets.end() - 1 );
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		for ( int j = 0; j < 2; j++ )
+		{
+			const int bodyIdx = m_topology[3 * i + j];
+
+			if ( bodyIdx != SolverBody::STATIC_BODY_IDX )
+			{
+				bodyPairs[cursor[bodyIdx]++] = i;
+			}
+		}
+	}
+
+	std::vector<int> pairDegrees( numPairs, 0 );
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		for ( int j = 0; j < 2; j++ )
+		{
+			const int bodyIdx = m_topology[3 * i + j];
+
+			if ( bodyIdx != SolverBody::STATIC_BODY_IDX )
+			{
+				pairDegrees[i] += bodyPairOffsets[bodyIdx + 1] - bodyPairOffsets[bodyIdx] - 1;
+			}
+		}
+	}
+
+	const auto byDegree = [&pairDegrees]( int a, int b ) { return pairDegrees[a] < pairDegrees[b]; };
+
+	// Reverse Cuthill-McKee, breadth first from the loosest pair walks chains end to end
+	// and keeps coupled rows close together, which bounds fill of L by the bandwidth
+	std::vector<int> startPairs( numPairs );
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		startPairs[i] = i;
+	}
+
+	std::stable_sort( startPairs.begin(), startPairs.end(), byDegree );
+
+	std::vector<int> pairOrder;
+	std::vector<bool> isOrdered( numPairs, false );
+
+	for ( int s = 0; s < numPairs; s++ )
+	{
+		if ( isOrdered[startPairs[s]] )
+		{
+			continue;
+		}
+
+		isOrdered[startPairs[s]] = true;
+		pairOrder.push_back( startPairs[s] );
+
+		for ( int head = ( int )pairOrder.size() - 1; head < ( int )pairOrder.size(); head++ )
+		{
+			const int pairIdx = pairOrder[head];
+			const int firstNewIdx = ( int )pairOrder.size();
+
+			for ( int j = 0; j < 2; j++ )
+			{
+				const int bodyIdx = m_topology[3 * pairIdx + j];
+
+				for ( int k = bodyPairOffsets[bodyIdx]; k < bodyPairOffsets[bodyIdx + 1]; k++ )
+				{
+					if ( !isOrdered[bodyPairs[k]] )
+					{
+						isOrdered[bodyPairs[k]] = true;
+						pairOrder.push_back( bodyPairs[k] );
+					}
+				}
+			}
+
+			std::stable_sort( pairOrder.begin() + firstNewIdx, pairOrder.end(), byDegree );
+		}
+	}
+
+	std::reverse( pairOrder.begin(), pairOrder.end() );
+
+	// Rows of a pair take consecutive columns
+	std::vector<int> rowColumns( numRows );
+	std::vector<int> rowPairs( numRows );
+	structureOut.columnRows.clear();
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		const int pairIdx = pairOrder[i];
+
+		for ( int rowIdx = pairRowOffsets[pairIdx]; rowIdx < pairRowOffsets[pairIdx + 1]; rowIdx++ )
+		{
+			rowColumns[rowIdx] = ( int )structureOut.columnRows.size();
+			rowPairs[rowIdx] = pairIdx;
+			structureOut.columnRows.push_back( rowIdx );
+		}
+	}
+
+	// Rows couple when their pairs share a dynamic body, upper triangle only
+	std::vector<int> pairMarks( numPairs, -1 );
+	SymmetricSparseMatrix& matrix = structureOut.matrix;
+	matrix.beginPattern( numRows );
+
+	for ( int col = 0; col < numRows; col++ )
+	{
+		const int pairIdx = rowPairs[structureOut.columnRows[col]];
+
+		for ( int j = 0; j < 2; j++ )
+		{
+			const int bodyIdx = m_topology[3 * pairIdx + j];
+
+			for ( int k = bodyPairOffsets[bodyIdx]; k < bodyPairOffsets[bodyIdx + 1]; k++ )
+			{
+				const int otherPairIdx = bodyPairs[k];
+
+				if ( pairMarks[otherPairIdx] == col )
+				{
+					continue;
+				}
+
+				pairMarks[otherPairIdx] = col;
+
+				for ( int rowIdx = pairRowOffsets[otherPairIdx]; rowIdx < pairRowOffsets[otherPairIdx + 1]; rowIdx++ )
+				{
+					if ( rowColumns[rowIdx] <= col )
+					{
+						matrix.addEntry( rowColumns[rowIdx] );
+					}
+				}
+			}
+		}
+
+		matrix.endColumn();
+	}
+
+	structureOut.ldlt.analyze( matrix );
+}
+
+int physicsDirectSolver::solve(
+	const SolverInfo& info,
+	const std::vector<ConstrainedPair>& constrainedPairs,
+	const std::vector<int>& pairRowOffsets,
+	std::vector<SolverRow>& rows,
+	std::vector<SolverBody>& solverBodies )
+{
+	const int numRows = ( int )rows.size();
+
+	if ( numRows == 0 )
+	{
+		return 0;
+	}
+
+	DirectSolverStructure& structure = findStructure( constrainedPairs, pairRowOffsets, solverBodies );
+	SymmetricSparseMatrix& matrix = structure.matrix;
+	const std::vector<int>& columnRows = structure.columnRows;
+
+	for ( int col = 0; col < numRows; col++ )
+	{
+		const SolverRow& row = rows[columnRows[col]];
+		Assert( row.type == Constraint::BILATERAL, "direct solver can't bound impulses" );
+
+		for ( int entryIdx = matrix.getColumnBegin( col ); entryIdx < matrix.getColumnBegin( col + 1 ); entryIdx++ )
+		{
+			const int otherCol = matrix.getEntryRow( entryIdx );
+
+			matrix.getEntryValue( entryIdx ) = ( otherCol == col ) ?
+				row.JmJ : calcRowCoupling( rows[columnRows[otherCol]], row, solverBodies );
+		}
+	}
+
+	const int numDependentRows = structure.ldlt.factorize( matrix, g_directSolverPivotTolerance );
+
+	// Impulses taking relative velocity along each row to its bias
+	m_rhs.resize( numRows );
+
+	for ( int col = 0; col < numRows; col++ )
+	{
+		const SolverRow& row = rows[columnRows[col]];
+		const SolverBody& bodyA = solverBodies[row.bodyIdxA];
+		const SolverBody& bodyB = solverBodies[row.bodyIdxB];
+		const Jacobian& jac = row.jac;
+
+		const Real Jv =
+			jac.vA.dot<2>( bodyA.v ) + jac.wA( 2 ) * bodyA.w( 2 ) +
+			jac.vB.dot<2>( bodyB.v ) + jac.wB( 2 ) * bodyB.w( 2 );
+
+		m_rhs[col] = row.biasRate * row.error - Jv;
+	}
+
+	structure.ldlt.solve( m_rhs );
+
+	for ( int col = 0; col < numRows; col++ )
+	{
+		SolverRow& row = rows[columnRows[col]];
+
+		Assert( !isinf( m_rhs[col] ), "infinite impulse in direct solver" );
+		Assert( !isnan( m_rhs[col] ), "nan impulse in direct solver" );
+
+		row.accumImp = m_rhs[col];
+		solverBodies[row.bodyIdxA].applyImpulse( row.jac.vA, row.jac.wA, row.accumImp );
+		solverBodies[row.bodyIdxB].applyImpulse( row.jac.vB, row.jac.wB, row.accumImp );
+	}
+
+	// Split impulse uses the same system on position deltas, so one more solve replaces position iterations
+	if ( info.m_numPositionIter > 0 )
+	{
+		for ( int col = 0; col < numRows; col++ )
+		{
+			const SolverRow& row = rows[columnRows[col]];
+			const SolverBody& bodyA = solverBodies[row.bodyIdxA];
+			const SolverBody& bodyB = solverBodies[row.bodyIdxB];
+			const Jacobian& jac = row.jac;
+
+			const Real Jdp =
+				jac.vA.dot<2>( bodyA.dp ) + jac.wA( 2 ) * bodyA.dRot +
+				jac.vB.dot<2>( bodyB.dp ) + jac.wB( 2 ) * bodyB.dRot;
+
+			m_rhs[col] = row.positionBias * row.error - Jdp;
+		}
+
+		structure.ldlt.solve( m_rhs );
+
+		for ( int col = 0; col < numRows; col++ )
+		{
+			SolverRow& row = rows[columnRows[col]];
+
+			row.accumPositionImp = m_rhs[col];
+			solverBodies[row.bodyIdxA].applyPositionImpulse( row.jac.vA, row.jac.wA, row.accumPositionImp );
+			solverBodies[row.bodyIdxB].applyPositionImpulse( row.jac.vB, row.jac.wB, row.accumPositionImp );
+		}
+	}
+
+	return numDependentRows;
+}
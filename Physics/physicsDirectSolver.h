@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <physicsSolver.h>
+
+// Nonzero structure of one island's system, reused while its pairs keep connecting the same bodies
+struct DirectSolverStructure
+{
+	// Per pair solver body index of A and B, or the static body for bodies which aren't dynamic, and number of rows
+	std::vector<int> topology;
+
+	std::vector<int> columnRows; // Row of each matrix column, pairs ordered to keep fill of L low
+	SymmetricSparseMatrix matrix;
+	SparseLdlt ldlt;
+	int lastUsed;
+};
+
+// Solves equality rows exactly with one sparse LDL^T factorization of J M^-1 J^T instead of iterating,
+// so long chains and heavy mass ratios converge in a single solve
+// Factorization structure is cached per topology, so only values are re-computed while joints stay the same
+class physicsDirectSolver
+{
+public:
+
+	physicsDirectSolver();
+
+	// Rows must all be BILATERAL, prepared from pairs with rows of nth pair spanning [pairRowOffsets[n], pairRowOffsets[n + 1])
+	// Velocities and accumulated impulses are solved in one go, position deltas too for split impulse
+	// Returns number of rows left without impulse as redundant, e.g. closing a loop, or too badly conditioned to tell
+	int solve(
+		const SolverInfo& info,
+		const std::vector<ConstrainedPair>& constrainedPairs,
+		const std::vector<int>& pairRowOffsets,
+		std::vector<SolverRow>& rows,
+		std::vector<SolverBody>& solverBodies
+	);
+
+private:
+
+	// Find cached structure of the pairs' topology, building it on a miss
+	DirectSolverStructure& findStructure(
+		const std::vector<ConstrainedPair>& constrainedPairs,
+		const std::vector<int>& pairRowOffsets,
+		const std::vector<SolverBody>& solverBodies
+	);
+
+	// Order pairs along the chains they form and find the pattern of the system and its factor
+	void buildStructure(
+		const std::vector<ConstrainedPair>& constrainedPairs,
+		const std::vector<int>& pairRowOffsets,
+		const std::vector<SolverBody>& solverBodies,
+		DirectSolverStructure& structureOut
+	);
+
+	std::vector<DirectSolverStructure> m_structures;
+	int m_numSolves;
+
+	// Scratch
+	std::vector<int> m_topology;
+	std::vector<Real> m_rhs;
+};
@@ -0,0 +1,215 @@
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#if defined _MSC_VER
+#include <malloc.h> // _aligned_malloc
+#endif
+
+#include <Base.h>
+#include <physicsFrameArena.h>
+
+#if defined PHYSICS_COUNT_ALLOCATIONS
+
+static std::atomic<long long> s_numAllocations( 0 );
+
+void* operator new( size_t size )
+{
+	s_numAllocations++;
+
+	void* ptr = malloc( size ? size : 1 );
+	if ( ptr == nullptr )
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+void* operator new( size_t size, const std::nothrow_t& ) noexcept
+{
+	s_numAllocations++;
+	return malloc( size ? size : 1 );
+}
+
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept
+{
+	return operator new( size, std::nothrow );
+}
+
+void operator delete( void* ptr ) noexcept { free( ptr ); }
+void operator delete[]( void* ptr ) noexcept { free( ptr ); }
+void operator delete( void* ptr, size_t ) noexcept { free( ptr ); }
+void operator delete[]( void* ptr, size_t ) noexcept { free( ptr ); }
+void operator delete( void* ptr, const std::nothrow_t& ) noexcept { free( ptr ); }
+void operator delete[]( void* ptr, const std::nothrow_t& ) noexcept { free( ptr ); }
+
+#if defined __cpp_aligned_new
+
+// Over-aligned types, freed by the aligned deletes only
+static void* allocateAligned( size_t size, std::align_val_t alignment )
+{
+	s_numAllocations++;
+
+	const size_t align = static_cast< size_t >( alignment );
+#if defined _MSC_VER
+	return _aligned_malloc( size ? size : 1, align );
+#else
+	// Size has to be a multiple of alignment
+	return aligned_alloc( align, ( ( size ? size : 1 ) + align - 1 ) / align * align );
+#endif
+}
+
+static void freeAligned( void* ptr )
+{
+#if defined _MSC_VER
+	_aligned_free( ptr );
+#else
+	free( ptr );
+#endif
+}
+
+void* operator new( size_t size, std::align_val_t alignment )
+{
+	void* ptr = allocateAligned( size, alignment );
+	if ( ptr == nullptr )
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void* operator new[]( size_t size, std::align_val_t alignment )
+{
+	return operator new( size, alignment );
+}
+
+void* operator new( size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+	return allocateAligned( size, alignment );
+}
+
+void* operator new[]( size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+	return allocateAligned( size, alignment );
+}
+
+void operator delete( void* ptr, std::align_val_t ) noexcept { freeAligned( ptr ); }
+void operator delete[]( void* ptr, std::align_val_t ) noexcept { freeAligned( ptr ); }
+void operator delete( void* ptr, size_t, std::align_val_t ) noexcept { freeAligned( ptr ); }
+void operator delete[]( void* ptr, size_t, std::align_val_t ) noexcept { freeAligned( ptr ); }
+void operator delete( void* ptr, std::align_val_t, const std::nothrow_t& ) noexcept { freeAligned( ptr ); }
+void operator delete[]( void* ptr, std::align_val_t, const std::nothrow_t& ) noexcept { freeAligned( ptr ); }
+
+#endif
+
+#endif
+
+namespace physicsAllocationCounter
+{
+	bool isCounting()
+	{
+#if defined PHYSICS_COUNT_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	long long getNumAllocations()
+	{
+#if defined PHYSICS_COUNT_ALLOCATIONS
+		return s_numAllocations;
+#else
+		return 0;
+#endif
+	}
+}
+
+physicsFrameArena::physicsFrameArena( size_t initialCapacity ) :
+	m_offset( 0 ),
+	m_numBytesUsed( 0 )
+{
+	addChunk( initialCapacity );
+}
+
+physicsFrameArena::~physicsFrameArena()
+{
+	for ( auto iter = m_chunks.begin(); iter != m_chunks.end(); iter++ )
+	{
+		::operator delete( iter->data );
+	}
+}
+
+void* physicsFrameArena::allocate( size_t size, size_t alignment )
+{
+	Assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0, "alignment must be power of two" );
+
+	const Chunk* chunk = &m_chunks.back();
+	uintptr_t begin = ( uintptr_t )chunk->data + m_offset;
+	uintptr_t aligned = ( begin + alignment - 1 ) & ~( uintptr_t )( alignment - 1 );
+
+	if ( aligned + size > ( uintptr_t )chunk->data + chunk->size )
+	{
+		addChunk( std::max( 2 * chunk->size, size + alignment ) );
+
+		chunk = &m_chunks.back();
+		begin = ( uintptr_t )chunk->data;
+		aligned = ( begin + alignment - 1 ) & ~( uintptr_t )( alignment - 1 );
+	}
+
+	m_offset = ( size_t )( aligned + size - ( uintptr_t )chunk->data );
+	m_numBytesUsed += size;
+
+	return ( void* )aligned;
+}
+
+void physicsFrameArena::reset()
+{
+	// Last step needed more than one chunk, replace them with one holding all of it
+	if ( m_chunks.size() > 1 )
+	{
+		const size_t capacity = getCapacity();
+
+		for ( auto iter = m_chunks.begin(); iter != m_chunks.end(); iter++ )
+		{
+			::operator delete( iter->data );
+		}
+
+		m_chunks.clear();
+		addChunk( capacity );
+	}
+
+	m_offset = 0;
+	m_numBytesUsed = 0;
+}
+
+size_t physicsFrameArena::getCapacity() const
+{
+	size_t capacity = 0;
+
+	for ( auto iter = m_chunks.begin(); iter != m_chunks.end(); iter++ )
+	{
+		capacity += iter->size;
+	}
+
+	return capacity;
+}
+
+void physicsFrameArena::addChunk( size_t size )
+{
+	Chunk chunk;
+	chunk.data = static_cast< char* >( ::operator new( size, std::nothrow ) );
+	chunk.size = size;
+	Assert( chunk.data != nullptr, "out of memory for frame arena" );
+
+	m_chunks.push_back( chunk );
+	m_offset = 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Allocations made through global operator new by any thread, the frame arena's chunks included
+// Counting replaces global operator new and delete of the whole program, bypassing any debug heap,
+// so it is only built in when PHYSICS_COUNT_ALLOCATIONS is defined
+// A step only allocates when the world reaches a new peak: more contact pairs than in any step before,
+// or with SEQUENTIAL and SIMD solvers, a thread solving a bigger island than it has solved before
+// Once those stop growing, a step leaves the count unchanged
+namespace physicsAllocationCounter
+{
+	bool isCounting();
+
+	// Since program start, zero when not counting
+	long long getNumAllocations();
+}
+
+// Linear allocator for buffers living no longer than one step
+// Allocating bumps an offset and freeing does nothing, reset() releases everything at once
+// Running out of a chunk adds a bigger one, reset() merges chunks so steady steps fit in one chunk
+// and stop allocating, see physicsAllocationCounter
+// Not thread safe, only the serial parts of a step allocate from it
+class physicsFrameArena
+{
+public:
+
+	physicsFrameArena( size_t initialCapacity = 64 * 1024 );
+
+	~physicsFrameArena();
+
+	void* allocate( size_t size, size_t alignment );
+
+	// Invalidates everything allocated since last reset
+	void reset();
+
+	size_t getNumBytesUsed() const { return m_numBytesUsed; }
+
+	size_t getCapacity() const;
+
+private:
+
+	physicsFrameArena( const physicsFrameArena& );
+	physicsFrameArena& operator=( const physicsFrameArena& );
+
+	void addChunk( size_t size );
+
+	struct Chunk
+	{
+		char* data;
+		size_t size;
+	};
+
+	std::vector<Chunk> m_chunks; // Allocations come from the last chunk
+	size_t m_offset;             // Into last chunk
+	size_t m_numBytesUsed;
+};
+
+// Allocator for standard containers backed by a frame arena
+template <typename T>
+class physicsFrameAllocator
+{
+public:
+
+	typedef T value_type;
+
+	// Non-explicit, so containers can be constructed from the arena directly
+	physicsFrameAllocator( physicsFrameArena& arena ) : m_arena( &arena ) {}
+
+	template <typename U>
+	physicsFrameAllocator( const physicsFrameAllocator<U>& other ) : m_arena( other.getArena() ) {}
+
+	T* allocate( size_t n ) { return static_cast< T* >( m_arena->allocate( n * sizeof( T ), alignof( T ) ) ); }
+
+	void deallocate( T*, size_t ) {}
+
+	physicsFrameArena* getArena() const { return m_arena; }
+
+private:
+
+	physicsFrameArena* m_arena;
+};
+
+template <typename T, typename U>
+inline bool operator == ( const physicsFrameAllocator<T>& a, const physicsFrameAllocator<U>& b )
+{
+	return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+inline bool operator != ( const physicsFrameAllocator<T>& a, const physicsFrameAllocator<U>& b )
+{
+	return a.getArena() != b.getArena();
+}
+
+// Vector whose storage is gone after the arena's next reset
+template <typename T>
+using FrameVector = std::vector<T, physicsFrameAllocator<T>>;
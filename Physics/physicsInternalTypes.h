@@ -21,9 +21,11 @@ bool bodyIdPairLess( const BodyIdPair& pairA, const BodyIdPair& pairB );
 
 namespace BodyIdPairsUtils
 {
+	// Containers are vectors of pairs, they may use different allocators
+
 	// Add contents of vector B to vector A, clear B after
-	template <typename T>
-	inline void movePairsBtoA( std::vector<T>& a, std::vector<T>& b )
+	template <typename VectorA, typename VectorB>
+	inline void movePairsBtoA( VectorA& a, VectorB& b )
 	{
 		a.insert( std::end( a ), std::begin( b ), std::end( b ) );
 		b.clear();
@@ -32,9 +34,8 @@ namespace BodyIdPairsUtils
 	// Classifies contents of a and b into intersection and relative complements
 	// i.e. c = ab', d = ab, e = a'b
 	// Contents of a and b must be sorted in ascending order
-	template <typename T1, typename T2>
-	void classifyPairSets( const std::vector<T1>& a, const std::vector<T2>& b,
-						   std::vector<T2>& c, std::vector<T2>& d, std::vector<T2>& e )
+	template <typename VectorA, typename VectorB, typename VectorC, typename VectorD, typename VectorE>
+	void classifyPairSets( const VectorA& a, const VectorB& b, VectorC& c, VectorD& d, VectorE& e )
 	{
 		auto iterA = a.begin();
 		auto iterB = b.begin();
@@ -72,8 +73,8 @@ namespace BodyIdPairsUtils
 	}
 
 	// TODO: Find other way to do this as this is costly
-	template <typename T1, typename T2>
-	void deletePairsBfromA( std::vector<T1>& a, const std::vector<T2>& b )
+	template <typename VectorA, typename VectorB>
+	void deletePairsBfromA( VectorA& a, const VectorB& b )
 	{
 		auto iterA = a.begin();
 		auto iterB = b.begin();
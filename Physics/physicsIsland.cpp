@@ -0,0 +1,178 @@
+#include <vector>
+
+#include <Base.h>
+#include <physicsIsland.h>
+
+void physicsIslandBuilder::buildIslands(
+	const physicsBodyStorage& bodies,
+	const std::vector<BodyId>& activeBodyIds,
+	const std::vector<ConstrainedPair>& contactPairs,
+	const std::vector<ConstrainedPair>& jointPairs )
+{
+	const int numBodies = bodies.getNumSlots();
+
+	m_parents.resize( numBodies );
+	m_rootIslandIdxs.assign( numBodies, -1 );
+
+	for ( int i = 0; i < ( int )activeBodyIds.size(); i++ )
+	{
+		const int bodyIdx = getBodyIdx( activeBodyIds[i] );
+		m_parents[bodyIdx] = bodyIdx;
+	}
+
+	// Only link simulated bodies, static bodies separate islands and sleeping bodies are left out
+	for ( int i = 0; i < ( int )contactPairs.size(); i++ )
+	{
+		const ConstrainedPair& pair = contactPairs[i];
+		if ( bodies.isSimulated( pair.bodyIdA ) && bodies.isSimulated( pair.bodyIdB ) )
+		{
+			unite( pair.bodyIdA, pair.bodyIdB );
+		}
+	}
+
+	for ( int i = 0; i < ( int )jointPairs.size(); i++ )
+	{
+		const ConstrainedPair& pair = jointPairs[i];
+		if ( bodies.isSimulated( pair.bodyIdA ) && bodies.isSimulated( pair.bodyIdB ) )
+		{
+			unite( pair.bodyIdA, pair.bodyIdB );
+		}
+	}
+
+	// Every simulated body goes to its root's island, unconstrained bodies get an island of their own
+	// Islands are numbered in order of their first active body
+	const int numActiveBodies = ( int )activeBodyIds.size();
+	m_numIslands = 0;
+	m_bodyIslandIdxs.resize( numActiveBodies );
+
+	for ( int i = 0; i < numActiveBodies; i++ )
+	{
+		const BodyId bodyId = activeBodyIds[i];
+
+		if ( !bodies.isSimulated( bodyId ) )
+		{
+			m_bodyIslandIdxs[i] = -1;
+			continue;
+		}
+
+		const int root = findRoot( bodyId );
+
+		if ( m_rootIslandIdxs[root] < 0 )
+		{
+			m_rootIslandIdxs[root] = m_numIslands++;
+		}
+
+		m_bodyIslandIdxs[i] = m_rootIslandIdxs[root];
+	}
+
+	m_contactPairIslandIdxs.resize( contactPairs.size() );
+	for ( int i = 0; i < ( int )contactPairs.size(); i++ )
+	{
+		m_contactPairIslandIdxs[i] = getPairIslandIdx( bodies, contactPairs[i] );
+	}
+
+	m_jointPairIslandIdxs.resize( jointPairs.size() );
+	for ( int i = 0; i < ( int )jointPairs.size(); i++ )
+	{
+		m_jointPairIslandIdxs[i] = getPairIslandIdx( bodies, jointPairs[i] );
+	}
+
+	// Bodies and pairs keep their relative order within an island
+	sortByIsland( m_bodyIslandIdxs, m_bodyOffsets, m_sortedBodyIdxs );
+	sortByIsland( m_contactPairIslandIdxs, m_contactPairOffsets, m_contactPairIdxs );
+	sortByIsland( m_jointPairIslandIdxs, m_jointPairOffsets, m_jointPairIdxs );
+
+	m_bodyIds.resize( m_sortedBodyIdxs.size() );
+	for ( int i = 0; i < ( int )m_sortedBodyIdxs.size(); i++ )
+	{
+		m_bodyIds[i] = activeBodyIds[m_sortedBodyIdxs[i]];
+	}
+}
+
+physicsIsland physicsIslandBuilder::getIsland( int islandIdx ) const
+{
+	physicsIsland island;
+	island.bodyIds = m_bodyIds.data() + m_bodyOffsets[islandIdx];
+	island.contactPairIdxs = m_contactPairIdxs.data() + m_contactPairOffsets[islandIdx];
+	island.jointPairIdxs = m_jointPairIdxs.data() + m_jointPairOffsets[islandIdx];
+	island.numBodies = m_bodyOffsets[islandIdx + 1] - m_bodyOffsets[islandIdx];
+	island.numContactPairs = m_contactPairOffsets[islandIdx + 1] - m_contactPairOffsets[islandIdx];
+	island.numJointPairs = m_jointPairOffsets[islandIdx + 1] - m_jointPairOffsets[islandIdx];
+
+	return island;
+}
+
+void physicsIslandBuilder::sortByIsland( const std::vector<int>& islandIdxs, std::vector<int>& offsetsOut, std::vector<int>& sortedOut )
+{
+	offsetsOut.assign( m_numIslands + 1, 0 );
+
+	for ( int i = 0; i < ( int )islandIdxs.size(); i++ )
+	{
+		if ( islandIdxs[i] >= 0 )
+		{
+			offsetsOut[islandIdxs[i] + 1]++;
+		}
+	}
+
+	for ( int i = 0; i < m_numIslands; i++ )
+	{
+		offsetsOut[i + 1] += offsetsOut[i];
+	}
+
+	m_cursors.assign( offsetsOut.begin(), offsetsOut.end() - 1 );
+	sortedOut.resize( offsetsOut[m_numIslands] );
+
+	for ( int i = 0; i < ( int )islandIdxs.size(); i++ )
+	{
+		if ( islandIdxs[i] >= 0 )
+		{
+			sortedOut[m_cursors[islandIdxs[i]]++] = i;
+		}
+	}
+}
+
+int physicsIslandBuilder::findRoot( BodyId bodyId )
+{
+	int bodyIdx = getBodyIdx( bodyId );
+
+	// Path halving
+	while ( m_parents[bodyIdx] != bodyIdx )
+	{
+		m_parents[bodyIdx] = m_parents[m_parents[bodyIdx]];
+		bodyIdx = m_parents[bodyIdx];
+	}
+
+	return bodyIdx;
+}
+
+void physicsIslandBuilder::unite( BodyId bodyIdA, BodyId bodyIdB )
+{
+	const int rootA = findRoot( bodyIdA );
+	const int rootB = findRoot( bodyIdB );
+
+	if ( rootA != rootB )
+	{
+		m_parents[rootA] = rootB;
+	}
+}
+
+int physicsIslandBuilder::getPairIslandIdx( const physicsBodyStorage& bodies, const BodyIdPair& pair )
+{
+	BodyId simulatedBodyId = invalidId;
+
+	if ( bodies.isSimulated( pair.bodyIdA ) )
+	{
+		simulatedBodyId = pair.bodyIdA;
+	}
+	else if ( bodies.isSimulated( pair.bodyIdB ) )
+	{
+		simulatedBodyId = pair.bodyIdB;
+	}
+
+	if ( simulatedBodyId == invalidId )
+	{
+		return -1;
+	}
+
+	return m_rootIslandIdxs[findRoot( simulatedBodyId )];
+}
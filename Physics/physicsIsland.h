@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <physicsInternalTypes.h>
+#include <physicsBody.h>
+#include <physicsSolver.h>
+
+// Group of simulated bodies connected through contacts or joints
+// Static bodies don't join islands, so islands touching the same static body stay separate
+// Views into the island builder's arrays, valid until islands are next built
+struct physicsIsland
+{
+	const BodyId* bodyIds; // Simulated bodies only
+	const int* contactPairIdxs;
+	const int* jointPairIdxs;
+	int numBodies;
+	int numContactPairs;
+	int numJointPairs;
+};
+
+// Per thread scratch for solving one island at a time
+// Holds the shared static body followed by the island's solver bodies,
+// pairs are moved in with solver body indices made local to the island
+struct physicsIslandSolveContext
+{
+	physicsSolver* solver;
+	std::vector<SolverBody> solverBodies;
+	std::vector<ConstrainedPair> contactPairs;
+	std::vector<ConstrainedPair> jointPairs;
+
+	physicsIslandSolveContext() : solver( nullptr ) {}
+};
+
+// Rebuilds islands each step with union-find over constrained pairs
+class physicsIslandBuilder
+{
+public:
+
+	physicsIslandBuilder() : m_numIslands( 0 ) {}
+
+	void buildIslands(
+		const physicsBodyStorage& bodies,
+		const std::vector<BodyId>& activeBodyIds,
+		const std::vector<ConstrainedPair>& contactPairs,
+		const std::vector<ConstrainedPair>& jointPairs
+	);
+
+	int getNumIslands() const { return m_numIslands; }
+
+	physicsIsland getIsland( int islandIdx ) const;
+
+private:
+
+	// Returns slot index of the root body
+	int findRoot( BodyId bodyId );
+
+	void unite( BodyId bodyIdA, BodyId bodyIdB );
+
+	// Island of pair's simulated body, -1 if neither body is simulated
+	int getPairIslandIdx( const physicsBodyStorage& bodies, const BodyIdPair& pair );
+
+	// Counting sort of element indices by island, keeping their relative order
+	// Elements of island i span [offsetsOut[i], offsetsOut[i + 1]) in sortedOut, elements of island -1 are left out
+	void sortByIsland( const std::vector<int>& islandIdxs, std::vector<int>& offsetsOut, std::vector<int>& sortedOut );
+
+	// Union-find forest of body slot indices
+	std::vector<int> m_parents;
+
+	// Island index of each root body, -1 for bodies not in an island
+	std::vector<int> m_rootIslandIdxs;
+
+	// Island of each active body and pair, -1 for elements outside of islands
+	std::vector<int> m_bodyIslandIdxs;
+	std::vector<int> m_contactPairIslandIdxs;
+	std::vector<int> m_jointPairIslandIdxs;
+
+	// Elements of all islands sorted by island, storage only grows with the world's totals
+	// rather than with the size of any one island
+	std::vector<int> m_sortedBodyIdxs; // Into active bodies
+	std::vector<BodyId> m_bodyIds;
+	std::vector<int> m_contactPairIdxs;
+	std::vector<int> m_jointPairIdxs;
+	std::vector<int> m_bodyOffsets;
+	std::vector<int> m_contactPairOffsets;
+	std::vector<int> m_jointPairOffsets;
+	std::vector<int> m_cursors;
+	int m_numIslands;
+};
@@ -0,0 +1,369 @@
+#include <Base.h>
+#include <physicsBody.h>
+#include <physicsJoint.h>
+
+physicsJoint::physicsJoint() :
+	bodyIdA( invalidId ),
+	bodyIdB( invalidId ),
+	axis( 1.f, 0.f ),
+	referenceAngle( 0.f ),
+	length( 0.f ),
+	enableLimit( false ),
+	lowerAngle( 0.f ),
+	upperAngle( 0.f ),
+	enableMotor( false ),
+	motorSpeed( 0.f ),
+	maxMotorTorque( 0.f )
+{
+	for ( int i = 0; i < MAX_ROWS; i++ )
+	{
+		accumImps[i] = 0.f;
+	}
+}
+
+void physicsJoint::setFromConfig( const JointConfig& config, const physicsBody& bodyA, const physicsBody& bodyB )
+{
+	bodyIdA = bodyA.getBodyId();
+	bodyIdB = bodyB.getBodyId();
+
+	const Vector4& pivotB = ( config.type == physicsJointType::DISTANCE ) ? config.pivotB : config.pivot;
+	rA = ( config.pivot - bodyA.getPosition() ).getInverseRotatedDir( bodyA.getRotationCosSin() );
+	rB = ( pivotB - bodyB.getPosition() ).getInverseRotatedDir( bodyB.getRotationCosSin() );
+	axis = config.axis.getNormalized<2>().getInverseRotatedDir( bodyA.getRotationCosSin() );
+	referenceAngle = bodyB.getRotation() - bodyA.getRotation();
+	length = ( pivotB - config.pivot ).length<2>();
+
+	enableLimit = config.enableLimit;
+	lowerAngle = config.lowerAngle;
+	upperAngle = config.upperAngle;
+	enableMotor = config.enableMotor;
+	motorSpeed = config.motorSpeed;
+	maxMotorTorque = config.maxMotorTorque;
+}
+
+// Rows keeping both anchors together along world x and y
+static void addPointConstraints( const physicsJoint& joint,
+								 const Vector4& posA, const Vector4& posB,
+								 const Vector4& rAworld, const Vector4& rBworld,
+								 std::vector<Constraint>& constraintsOut )
+{
+	const Vector4 separation = posA + rAworld - posB - rBworld;
+
+	for ( int axisIdx = 0; axisIdx < 2; axisIdx++ )
+	{
+		Constraint constraint;
+		constraint.rA = joint.rA;
+		constraint.rB = joint.rB;
+		constraint.error = -separation( axisIdx );
+		constraint.jac.vA.set( axisIdx == 0 ? 1.f : 0.f, axisIdx == 1 ? 1.f : 0.f );
+		constraint.jac.vB = constraint.jac.vA.getNegated();
+		constraint.jac.wA = rAworld.cross( constraint.jac.vA );
+		constraint.jac.wB = rBworld.cross( constraint.jac.vB );
+
+		constraintsOut.push_back( constraint );
+	}
+}
+
+// Row on relative angle of B to A, sign of one bounds angle from below and minus one from above
+static void addAngleConstraint( const Constraint::Type type, const Real sign, const Real error,
+								std::vector<Constraint>& constraintsOut )
+{
+	Constraint constraint;
+	constraint.type = type;
+	constraint.error = error;
+	constraint.jac.wA.set( 0.f, 0.f, -sign );
+	constraint.jac.wB.set( 0.f, 0.f, sign );
+
+	constraintsOut.push_back( constraint );
+}
+
+// Warm start rows with impulses stored in the joint
+static void setAccumImps( const physicsJoint& joint, const int firstConstraintIdx, std::vector<Constraint>& constraintsOut )
+{
+	Assert( ( int )constraintsOut.size() - firstConstraintIdx <= physicsJoint::MAX_ROWS, "too many joint rows" );
+
+	for ( int i = firstConstraintIdx; i < ( int )constraintsOut.size(); i++ )
+	{
+		constraintsOut[i].accumImp = joint.accumImps[i - firstConstraintIdx];
+	}
+}
+
+void setRevoluteConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+							 const Real h, std::vector<Constraint>& constraintsOut )
+{
+	const int firstConstraintIdx = ( int )constraintsOut.size();
+	const Vector4 rAworld = joint.rA.getRotatedDir( bodyA.getRotationCosSin() );
+	const Vector4 rBworld = joint.rB.getRotatedDir( bodyB.getRotationCosSin() );
+
+	addPointConstraints( joint, bodyA.getPosition(), bodyB.getPosition(), rAworld, rBworld, constraintsOut );
+
+	const Real angle = bodyB.getRotation() - bodyA.getRotation() - joint.referenceAngle;
+
+	if ( joint.enableLimit )
+	{
+		addAngleConstraint( Constraint::CONTACT, 1.f, joint.lowerAngle - angle, constraintsOut );
+		addAngleConstraint( Constraint::CONTACT, -1.f, angle - joint.upperAngle, constraintsOut );
+	}
+
+	if ( joint.enableMotor )
+	{
+		addAngleConstraint( Constraint::MOTOR, 1.f, joint.motorSpeed, constraintsOut );
+		constraintsOut.back().friction = joint.maxMotorTorque * h;
+	}
+
+	setAccumImps( joint, firstConstraintIdx, constraintsOut );
+}
+
+void setDistanceConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+							 const Real, std::vector<Constraint>& constraintsOut )
+{
+	const int firstConstraintIdx = ( int )constraintsOut.size();
+	const Vector4 rAworld = joint.rA.getRotatedDir( bodyA.getRotationCosSin() );
+	const Vector4 rBworld = joint.rB.getRotatedDir( bodyB.getRotationCosSin() );
+
+	Vector4 dir = bodyA.getPosition() + rAworld - bodyB.getPosition() - rBworld;
+	const Real currentLength = dir.length<2>();
+
+	// Coincident anchors have no direction, push apart along x
+	if ( currentLength > FLT_EPSILON )
+	{
+		dir /= currentLength;
+	}
+	else
+	{
+		dir.set( 1.f, 0.f );
+	}
+
+	Constraint constraint;
+	constraint.rA = joint.rA;
+	constraint.rB = joint.rB;
+	constraint.error = joint.length - currentLength;
+	constraint.jac.vA = dir;
+	constraint.jac.vB = dir.getNegated();
+	constraint.jac.wA = rAworld.cross( constraint.jac.vA );
+	constraint.jac.wB = rBworld.cross( constraint.jac.vB );
+	constraintsOut.push_back( constraint );
+
+	setAccumImps( joint, firstConstraintIdx, constraintsOut );
+}
+
+void setPrismaticConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+							  const Real, std::vector<Constraint>& constraintsOut )
+{
+	const int firstConstraintIdx = ( int )constraintsOut.size();
+	const Vector4 rAworld = joint.rA.getRotatedDir( bodyA.getRotationCosSin() );
+	const Vector4 rBworld = joint.rB.getRotatedDir( bodyB.getRotationCosSin() );
+	const Vector4 axisWorld = joint.axis.getRotatedDir( bodyA.getRotationCosSin() );
+	const Vector4 normal( -axisWorld( 1 ), axisWorld( 0 ) );
+
+	// Offset of B's anchor from A's across the axis, the axis turns with A
+	const Vector4 d = bodyB.getPosition() + rBworld - bodyA.getPosition() - rAworld;
+
+	Constraint constraint;
+	constraint.rA = joint.rA;
+	constraint.rB = joint.rB;
+	constraint.error = -d.dot<2>( normal );
+	constraint.jac.vA = normal.getNegated();
+	constraint.jac.vB = normal;
+	constraint.jac.wA = ( d + rAworld ).cross( normal ).getNegated();
+	constraint.jac.wB = rBworld.cross( normal );
+	constraintsOut.push_back( constraint );
+
+	const Real angle = bodyB.getRotation() - bodyA.getRotation() - joint.referenceAngle;
+	addAngleConstraint( Constraint::BILATERAL, 1.f, -angle, constraintsOut );
+
+	setAccumImps( joint, firstConstraintIdx, constraintsOut );
+}
+
+void setWeldConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+						 const Real, std::vector<Constraint>& constraintsOut )
+{
+	const int firstConstraintIdx = ( int )constraintsOut.size();
+	const Vector4 rAworld = joint.rA.getRotatedDir( bodyA.getRotationCosSin() );
+	const Vector4 rBworld = joint.rB.getRotatedDir( bodyB.getRotationCosSin() );
+
+	addPointConstraints( joint, bodyA.getPosition(), bodyB.getPosition(), rAworld, rBworld, constraintsOut );
+
+	const Real angle = bodyB.getRotation() - bodyA.getRotation() - joint.referenceAngle;
+	addAngleConstraint( Constraint::BILATERAL, 1.f, -angle, constraintsOut );
+
+	setAccumImps( joint, firstConstraintIdx, constraintsOut );
+}
+
+physicsJointPool::physicsJointPool() :
+	m_firstFreeSlot( -1 )
+{
+
+}
+
+JointId physicsJointPool::add( physicsJointType type, const physicsJoint& joint )
+{
+	int slotIdx;
+
+	if ( m_firstFreeSlot >= 0 )
+	{
+		// Re-use slot of a removed joint, its generation was bumped on removal
+		slotIdx = m_firstFreeSlot;
+		m_firstFreeSlot = m_slots[slotIdx].denseIdx;
+	}
+	else
+	{
+		slotIdx = ( int )m_slots.size();
+		Assert( slotIdx < ( int )INDEX_MASK, "too many joints" );
+
+		Slot slot;
+		slot.generation = 0;
+		m_slots.push_back( slot );
+	}
+
+	std::vector<physicsJoint>& joints = m_joints[( int )type];
+
+	Slot& slot = m_slots[slotIdx];
+	slot.type = type;
+	slot.denseIdx = ( int )joints.size();
+
+	joints.push_back( joint );
+	m_denseSlots[( int )type].push_back( slotIdx );
+
+	linkToBody( slotIdx, 0, joint.bodyIdA );
+	linkToBody( slotIdx, 1, joint.bodyIdB );
+
+	return getJointId( slotIdx );
+}
+
+void physicsJointPool::remove( JointId jointId )
+{
+	Assert( isValid( jointId ), "removing invalid joint" );
+
+	const int slotIdx = ( int )( jointId & INDEX_MASK );
+	unlinkFromBody( slotIdx, 0 );
+	unlinkFromBody( slotIdx, 1 );
+
+	Slot& slot = m_slots[slotIdx];
+	std::vector<physicsJoint>& joints = m_joints[( int )slot.type];
+	std::vector<int>& denseSlots = m_denseSlots[( int )slot.type];
+
+	// Move last joint of type into the hole
+	const int lastSlotIdx = denseSlots.back();
+	joints[slot.denseIdx] = joints.back();
+	denseSlots[slot.denseIdx] = lastSlotIdx;
+	m_slots[lastSlotIdx].denseIdx = slot.denseIdx;
+
+	joints.pop_back();
+	denseSlots.pop_back();
+
+	slot.generation++;
+	slot.denseIdx = m_firstFreeSlot;
+	m_firstFreeSlot = slotIdx;
+}
+
+bool physicsJointPool::isValid( JointId jointId ) const
+{
+	const int slotIdx = ( int )( jointId & INDEX_MASK );
+
+	if ( slotIdx >= ( int )m_slots.size() )
+	{
+		return false;
+	}
+
+	const Slot& slot = m_slots[slotIdx];
+	return ( slot.generation == ( unsigned short )( jointId >> INDEX_BITS ) &&
+			 slot.denseIdx >= 0 && slot.denseIdx < ( int )m_joints[( int )slot.type].size() &&
+			 m_denseSlots[( int )slot.type][slot.denseIdx] == slotIdx );
+}
+
+void physicsJointPool::removeJointsOfBody( BodyId bodyId )
+{
+	const int bodyIdx = getBodyIdx( bodyId );
+
+	if ( bodyIdx >= ( int )m_firstBodyLinks.size() )
+	{
+		return;
+	}
+
+	// Removal unlinks the joint, so the list head moves on to the next joint
+	while ( m_firstBodyLinks[bodyIdx] >= 0 )
+	{
+		remove( getJointId( m_firstBodyLinks[bodyIdx] >> 1 ) );
+	}
+}
+
+physicsJoint& physicsJointPool::get( JointId jointId )
+{
+	Assert( isValid( jointId ), "invalid joint" );
+
+	const Slot& slot = m_slots[jointId & INDEX_MASK];
+	return m_joints[( int )slot.type][slot.denseIdx];
+}
+
+const physicsJoint& physicsJointPool::get( JointId jointId ) const
+{
+	Assert( isValid( jointId ), "invalid joint" );
+
+	const Slot& slot = m_slots[jointId & INDEX_MASK];
+	return m_joints[( int )slot.type][slot.denseIdx];
+}
+
+int physicsJointPool::getNumJoints() const
+{
+	int numJoints = 0;
+
+	for ( int i = 0; i < ( int )physicsJointType::NUM_TYPES; i++ )
+	{
+		numJoints += ( int )m_joints[i].size();
+	}
+
+	return numJoints;
+}
+
+JointId physicsJointPool::getJointId( int slotIdx ) const
+{
+	return ( JointId )slotIdx | ( ( JointId )m_slots[slotIdx].generation << INDEX_BITS );
+}
+
+void physicsJointPool::linkToBody( int slotIdx, int end, BodyId bodyId )
+{
+	const int bodyIdx = getBodyIdx( bodyId );
+
+	if ( bodyIdx >= ( int )m_firstBodyLinks.size() )
+	{
+		m_firstBodyLinks.resize( bodyIdx + 1, -1 );
+	}
+
+	// Push to front of body's list
+	const int link = slotIdx * 2 + end;
+	const int nextLink = m_firstBodyLinks[bodyIdx];
+
+	Slot& slot = m_slots[slotIdx];
+	slot.bodyIdxs[end] = bodyIdx;
+	slot.prevLinks[end] = -1;
+	slot.nextLinks[end] = nextLink;
+
+	if ( nextLink >= 0 )
+	{
+		m_slots[nextLink >> 1].prevLinks[nextLink & 1] = link;
+	}
+
+	m_firstBodyLinks[bodyIdx] = link;
+}
+
+void physicsJointPool::unlinkFromBody( int slotIdx, int end )
+{
+	const Slot& slot = m_slots[slotIdx];
+	const int prevLink = slot.prevLinks[end];
+	const int nextLink = slot.nextLinks[end];
+
+	if ( prevLink >= 0 )
+	{
+		m_slots[prevLink >> 1].nextLinks[prevLink & 1] = nextLink;
+	}
+	else
+	{
+		m_firstBodyLinks[slot.bodyIdxs[end]] = nextLink;
+	}
+
+	if ( nextLink >= 0 )
+	{
+		m_slots[nextLink >> 1].prevLinks[nextLink & 1] = prevLink;
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+#include <physicsTypes.h>
+#include <physicsSolver.h>
+
+class physicsBody;
+
+enum class physicsJointType
+{
+	REVOLUTE = 0, // Bodies share a pivot and rotate freely about it, with optional angle limits and motor
+	DISTANCE,     // Anchors of both bodies kept at a fixed distance
+	PRISMATIC,    // Body B slides along an axis fixed in body A without rotating relative to it
+	WELD,         // Bodies share a pivot and keep their relative angle
+	NUM_TYPES
+};
+
+struct JointConfig
+{
+	physicsJointType type;
+	BodyId bodyIdA;
+	BodyId bodyIdB;
+	Vector4 pivot;  // World space anchor, shared by both bodies except for DISTANCE
+	Vector4 pivotB; // DISTANCE only, world space anchor of body B
+	Vector4 axis;   // PRISMATIC only, world space slide direction
+
+	// REVOLUTE only, angle of B relative to A measured from the angle at creation
+	bool enableLimit;
+	Real lowerAngle;
+	Real upperAngle;
+	bool enableMotor;
+	Real motorSpeed;     // Target relative angular speed
+	Real maxMotorTorque;
+
+	JointConfig() :
+		type( physicsJointType::REVOLUTE ),
+		bodyIdA( invalidId ),
+		bodyIdB( invalidId ),
+		axis( 1.f, 0.f ),
+		enableLimit( false ),
+		lowerAngle( 0.f ),
+		upperAngle( 0.f ),
+		enableMotor( false ),
+		motorSpeed( 0.f ),
+		maxMotorTorque( 0.f ) {}
+};
+
+// Joint as kept by the pool, anchors and axis are local to their body
+struct physicsJoint
+{
+	static const int MAX_ROWS = 5;
+
+	BodyId bodyIdA;
+	BodyId bodyIdB;
+	Vector4 rA;
+	Vector4 rB;
+	Vector4 axis; // PRISMATIC only, local to A
+	Real referenceAngle; // Angle of B minus angle of A at creation
+	Real length;         // DISTANCE only
+
+	bool enableLimit;
+	Real lowerAngle;
+	Real upperAngle;
+	bool enableMotor;
+	Real motorSpeed;
+	Real maxMotorTorque;
+
+	// Impulses of last step's rows, in order of the rows built for the joint
+	Real accumImps[MAX_ROWS];
+
+	physicsJoint();
+
+	// Anchors made local from config and bodies at their current placement
+	void setFromConfig( const JointConfig& config, const physicsBody& bodyA, const physicsBody& bodyB );
+};
+
+// Build constraint rows of a joint between its own bodies A and B, with impulses of last step for warm starting
+// Max impulse of motor rows is taken over one solver step of length h
+void setRevoluteConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+							 const Real h, std::vector<Constraint>& constraintsOut );
+void setDistanceConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+							 const Real h, std::vector<Constraint>& constraintsOut );
+void setPrismaticConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+							  const Real h, std::vector<Constraint>& constraintsOut );
+void setWeldConstraints( const physicsJoint& joint, const physicsBody& bodyA, const physicsBody& bodyB,
+						 const Real h, std::vector<Constraint>& constraintsOut );
+
+// Joints kept in one densely packed array per type, so rows of a type are built and solved together
+// Handles stay valid while other joints come and go, a removed joint's handle is rejected
+// even after its slot is re-used
+class physicsJointPool
+{
+public:
+
+	physicsJointPool();
+
+	JointId add( physicsJointType type, const physicsJoint& joint );
+
+	void remove( JointId jointId );
+
+	bool isValid( JointId jointId ) const;
+
+	// Remove joints attached to body, walking only its own joints
+	void removeJointsOfBody( BodyId bodyId );
+
+	physicsJoint& get( JointId jointId );
+
+	const physicsJoint& get( JointId jointId ) const;
+
+	int getNumJoints() const;
+
+	std::vector<physicsJoint>& getJoints( physicsJointType type ) { return m_joints[( int )type]; }
+
+	const std::vector<physicsJoint>& getJoints( physicsJointType type ) const { return m_joints[( int )type]; }
+
+private:
+
+	// Handle is slot index in low bits and slot generation in high bits
+	static const int INDEX_BITS = 16;
+	static const JointId INDEX_MASK = ( 1u << INDEX_BITS ) - 1;
+
+	// Each joint is linked into the joint list of both its bodies, end 0 for body A and 1 for body B
+	// Link is slot index * 2 + end, so joints of a body with itself are linked twice
+	struct Slot
+	{
+		unsigned short generation; // Bumped on removal
+		physicsJointType type;
+		int denseIdx;     // Index into m_joints[type], or next free slot while free
+		int bodyIdxs[2];
+		int prevLinks[2];
+		int nextLinks[2];
+	};
+
+	JointId getJointId( int slotIdx ) const;
+
+	void linkToBody( int slotIdx, int end, BodyId bodyId );
+
+	void unlinkFromBody( int slotIdx, int end );
+
+	std::vector<physicsJoint> m_joints[( int )physicsJointType::NUM_TYPES];
+
+	// Slot of each joint in m_joints, for fixing up slots when swap-removing
+	std::vector<int> m_denseSlots[( int )physicsJointType::NUM_TYPES];
+
+	std::vector<Slot> m_slots;
+	int m_firstFreeSlot;
+
+	// First link of each body's joint list by body index, -1 when body has no joints
+	std::vector<int> m_firstBodyLinks;
+};
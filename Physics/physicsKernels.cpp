@@ -0,0 +1,155 @@
+#include <Base.h>
+#include <physicsKernels.h>
+#include <physicsSolver.h>
+
+namespace physicsKernels
+{
+	// Scalar kernels, reference for wider ones
+
+	static int findOverlapsScalar( const SweepAabbs& aabbs, int aabbIdx, int* overlapsOut )
+	{
+		const Real minAx = aabbs.minX[aabbIdx], minAy = aabbs.minY[aabbIdx];
+		const Real maxAx = aabbs.maxX[aabbIdx], maxAy = aabbs.maxY[aabbIdx];
+		const Real centerAx = ( maxAx + minAx ) * 0.5f;
+		const Real centerAy = ( maxAy + minAy ) * 0.5f;
+
+		int numOverlaps = 0;
+
+		// Aabbs starting past max x of aabbIdx end the sweep
+		for ( int i = aabbIdx + 1; i < aabbs.numAabbs && aabbs.minX[i] <= maxAx; i++ )
+		{
+			const Real centerBx = ( aabbs.maxX[i] + aabbs.minX[i] ) * 0.5f;
+			const Real centerBy = ( aabbs.maxY[i] + aabbs.minY[i] ) * 0.5f;
+
+			const Real dx = fabs( centerAx - centerBx );
+			const Real dy = fabs( centerAy - centerBy );
+			const Real sumX = maxAx - centerAx + aabbs.maxX[i] - centerBx;
+			const Real sumY = maxAy - centerAy + aabbs.maxY[i] - centerBy;
+
+			if ( dx < sumX && dy < sumY )
+			{
+				overlapsOut[numOverlaps++] = i;
+			}
+		}
+
+		return numOverlaps;
+	}
+
+	static int findSupportingVertexScalar( const Real* xs, const Real* ys, int numVertices, Real dirX, Real dirY )
+	{
+		Real dotMax = std::numeric_limits<Real>::lowest();
+		int supportIdx = 0;
+
+		for ( int i = 0; i < numVertices; i++ )
+		{
+			const Real dot = dirX * xs[i] + dirY * ys[i];
+
+			if ( dot > dotMax )
+			{
+				dotMax = dot;
+				supportIdx = i;
+			}
+		}
+
+		return supportIdx;
+	}
+
+	static Real solveRowBatchesScalar( const SimdRowBatches& rows, Real* accumImp, SolverBody* solverBodies )
+	{
+		Real residual = 0.f;
+
+		// Rows of a batch don't share dynamic bodies, solving them one by one equals solving them at once
+		for ( int row = 0; row < rows.numBatches * rows.width; row++ )
+		{
+			SolverBody& bodyA = solverBodies[rows.bodyIdxA[row]];
+			SolverBody& bodyB = solverBodies[rows.bodyIdxB[row]];
+
+			const Real Jv =
+				( rows.jvAx[row] * bodyA.v( 0 ) + rows.jvAy[row] * bodyA.v( 1 ) + rows.jwA[row] * bodyA.w( 2 ) ) +
+				( rows.jvBx[row] * bodyB.v( 0 ) + rows.jvBy[row] * bodyB.v( 1 ) + rows.jwB[row] * bodyB.w( 2 ) );
+
+			Real impulse = ( rows.biasVel[row] - Jv ) * rows.invEffMass[row];
+
+			// Friction rows are bounded by impulse of their contact row, solved in an earlier batch
+			Real lower = rows.lower[row];
+			Real upper = rows.upper[row];
+
+			if ( rows.isFriction[row] > 0.f )
+			{
+				const Real limit = rows.friction[row] * accumImp[rows.normalRowIdx[row]];
+				lower = 0.f - limit;
+				upper = limit;
+			}
+
+			// Clamp accumulated impulse, apply only the difference
+			const Real oldImp = accumImp[row];
+			const Real newImp = std::min( std::max( oldImp + impulse, lower ), upper );
+			impulse = newImp - oldImp;
+			accumImp[row] = newImp;
+
+			bodyA.v( 0 ) += rows.mjvAx[row] * impulse;
+			bodyA.v( 1 ) += rows.mjvAy[row] * impulse;
+			bodyA.w( 2 ) += rows.mjwA[row] * impulse;
+			bodyB.v( 0 ) += rows.mjvBx[row] * impulse;
+			bodyB.v( 1 ) += rows.mjvBy[row] * impulse;
+			bodyB.w( 2 ) += rows.mjwB[row] * impulse;
+
+			residual = std::max( residual, fabs( impulse ) * rows.JmJ[row] );
+		}
+
+		return residual;
+	}
+
+	const physicsKernelTable& getScalarKernels()
+	{
+		static const physicsKernelTable table =
+		{
+			CpuFeatures::SimdLevel::SCALAR,
+			4, // SSE4.1 width
+			findOverlapsScalar,
+			findSupportingVertexScalar,
+			solveRowBatchesScalar
+		};
+
+		return table;
+	}
+
+	static const physicsKernelTable& getKernelsOfLevel( CpuFeatures::SimdLevel level )
+	{
+		switch ( level )
+		{
+		case CpuFeatures::SimdLevel::SSE41:
+			return getSse41Kernels();
+		case CpuFeatures::SimdLevel::AVX2:
+			return getAvx2Kernels();
+		case CpuFeatures::SimdLevel::AVX512:
+			return getAvx512Kernels();
+		default:
+			return getScalarKernels();
+		}
+	}
+
+	static const physicsKernelTable*& getSelectedKernels()
+	{
+		static const physicsKernelTable* s_kernels = &getKernelsOfLevel( CpuFeatures::getSupportedSimdLevel() );
+		return s_kernels;
+	}
+
+	const physicsKernelTable& get()
+	{
+		return *getSelectedKernels();
+	}
+
+	void setSimdLevel( CpuFeatures::SimdLevel level )
+	{
+		const CpuFeatures::SimdLevel supportedLevel = CpuFeatures::getSupportedSimdLevel();
+		Assert( supportedLevel >= CpuFeatures::SimdLevel::SSE41, "CPU lacks SSE4.1, which Vector4 needs" );
+
+		if ( level > supportedLevel )
+		{
+			level = supportedLevel;
+		}
+
+		getSelectedKernels() = &getKernelsOfLevel( level );
+	}
+}
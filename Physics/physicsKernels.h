@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Base.h>
+#include <Common/CpuFeatures.h>
+
+struct SolverBody;
+
+// Aabbs sorted by min x, each coordinate in its own array
+// Arrays hold physicsKernels::MAX_WIDTH entries past numAabbs which never overlap anything,
+// min x FLT_MAX and max x -FLT_MAX, so kernels may read a full vector past the last aabb
+struct SweepAabbs
+{
+	const Real* minX;
+	const Real* minY;
+	const Real* maxX;
+	const Real* maxY;
+	int numAabbs;
+};
+
+// Constraint rows of physicsSimdSolver in structure-of-arrays layout, lane l of batch b at row b * width + l
+// No two rows of a batch share a dynamic body, so a batch's rows are solved at once
+struct SimdRowBatches
+{
+	int width;
+	int numBatches;
+
+	// Jacobian
+	const Real* jvAx;
+	const Real* jvAy;
+	const Real* jwA;
+	const Real* jvBx;
+	const Real* jvBy;
+	const Real* jwB;
+
+	// Jacobian scaled by inverse mass, velocity change per unit impulse
+	const Real* mjvAx;
+	const Real* mjvAy;
+	const Real* mjwA;
+	const Real* mjvBx;
+	const Real* mjvBy;
+	const Real* mjwB;
+
+	const Real* invEffMass; // 1 / (J M^-1 J^T)
+	const Real* JmJ;        // J M^-1 J^T, zero for padded rows
+	const Real* biasVel;    // Velocity correcting position error
+	const Real* lower;      // Impulse bounds of contact and bilateral rows
+	const Real* upper;
+	const Real* friction;   // Friction coefficient, zero for other rows
+	const Real* isFriction; // One for friction rows, zero for others
+
+	const int* bodyIdxA;
+	const int* bodyIdxB;
+	const int* normalRowIdx; // Row of contact bounding a friction row, other rows point to themselves
+};
+
+// Hot batch kernels of one instruction set
+struct physicsKernelTable
+{
+	CpuFeatures::SimdLevel level;
+
+	// Rows per solver batch
+	int width;
+
+	// Write indices of aabbs after aabbIdx which overlap it to overlapsOut in increasing order, returns their count
+	// Overlap is tested like physicsAabb::overlaps()
+	int ( *findOverlaps )( const SweepAabbs& aabbs, int aabbIdx, int* overlapsOut );
+
+	// Index of first vertex with largest dot product with direction
+	// Vertex arrays are padded to a multiple of MAX_WIDTH with copies of the first vertex
+	int ( *findSupportingVertex )( const Real* xs, const Real* ys, int numVertices, Real dirX, Real dirY );
+
+	// Solve every batch once in order, returns largest |impulse| * J M^-1 J^T of any row
+	Real ( *solveRowBatches )( const SimdRowBatches& rows, Real* accumImp, SolverBody* solverBodies );
+};
+
+// Kernels are picked once by the CPU running the build, so one build uses the full vector width of every CPU
+// Translation units of instruction sets above SSE4.1 are compiled for their instruction set and only
+// use raw arrays and wide types, keeping code for wider instruction sets out of functions shared
+// with the rest of the build
+namespace physicsKernels
+{
+	// Widest lane count of any variant, padding of arrays read by kernels
+	const int MAX_WIDTH = 16;
+
+	// Kernels of highest level supported, unless lowered by setSimdLevel()
+	const physicsKernelTable& get();
+
+	// Use kernels of given level, higher levels than supported are clamped
+	// Scalar kernels solve batches as wide as SSE4.1's lane by lane, so both give the same results
+	// Not to be called while a world steps
+	void setSimdLevel( CpuFeatures::SimdLevel level );
+
+	// Tables of each level, defined in the level's translation unit
+	// Only valid to use on CPUs supporting the level
+	const physicsKernelTable& getScalarKernels();
+	const physicsKernelTable& getSse41Kernels();
+	const physicsKernelTable& getAvx2Kernels();
+	const physicsKernelTable& getAvx512Kernels();
+}
@@ -0,0 +1,23 @@
+#include <Base.h>
+#include <Common/Vec2x8.h>
+#include <physicsKernels.h>
+#include <physicsWideKernels.h>
+
+// Compiled with AVX2 enabled, see Physics.vcxproj
+
+namespace physicsKernels
+{
+	const physicsKernelTable& getAvx2Kernels()
+	{
+		static const physicsKernelTable table =
+		{
+			CpuFeatures::SimdLevel::AVX2,
+			Realx8::WIDTH,
+			findOverlapsWide<Realx8>,
+			findSupportingVertexWide<Vec2x8, Realx8>,
+			solveRowBatchesWide<Realx8>
+		};
+
+		return table;
+	}
+}
@@ -0,0 +1,23 @@
+#include <Base.h>
+#include <Common/Vec2x16.h>
+#include <physicsKernels.h>
+#include <physicsWideKernels.h>
+
+// Compiled with AVX-512 enabled, see Physics.vcxproj
+
+namespace physicsKernels
+{
+	const physicsKernelTable& getAvx512Kernels()
+	{
+		static const physicsKernelTable table =
+		{
+			CpuFeatures::SimdLevel::AVX512,
+			Realx16::WIDTH,
+			findOverlapsWide<Realx16>,
+			findSupportingVertexWide<Vec2x16, Realx16>,
+			solveRowBatchesWide<Realx16>
+		};
+
+		return table;
+	}
+}
@@ -0,0 +1,22 @@
+#include <Base.h>
+#include <physicsKernels.h>
+#include <physicsWideKernels.h>
+
+// Baseline flags, SSE4.1 is needed by Vector4 anyway
+
+namespace physicsKernels
+{
+	const physicsKernelTable& getSse41Kernels()
+	{
+		static const physicsKernelTable table =
+		{
+			CpuFeatures::SimdLevel::SSE41,
+			Realx4::WIDTH,
+			findOverlapsWide<Realx4>,
+			findSupportingVertexWide<Vec2x4, Realx4>,
+			solveRowBatchesWide<Realx4>
+		};
+
+		return table;
+	}
+}
@@ -1,5 +1,6 @@
 #include <physicsShape.h>
 #include <physicsAabb.h>
+#include <physicsKernels.h>
 
 #include <vector>
 #include <climits>
@@ -78,11 +79,6 @@ bool physicsCircleShape::containsPoint( const Vector4& point ) const
 	return false;
 }
 
-void physicsCircleShape::getSupportingVertex( const Vector4& direction, Vector4& point ) const
-{
-	point.setMul( direction.getNormalized<2>(), m_radius );
-}
-
 physicsAabb physicsCircleShape::getAabb( const Real rot ) const
 {
 	Vector4 halfExtent; halfExtent.setAll( m_radius );
@@ -135,55 +131,22 @@ bool physicsBoxShape::containsPoint( const Vector4& point ) const
 	return false;
 }
 
-void physicsBoxShape::getSupportingVertex( const Vector4& direction, Vector4& point ) const
+physicsAabb physicsBoxShape::getAabb( const Real rot ) const
 {
-	Vector4 dirNw( -m_halfExtents( 0 ), m_halfExtents( 1 ) );
-	Vector4 dirSw( -m_halfExtents( 0 ), -m_halfExtents( 1 ) );
-	Vector4 dirSe( m_halfExtents( 0 ), -m_halfExtents( 1 ) );
-	Vector4 dirNe( m_halfExtents( 0 ), m_halfExtents( 1 ) );
-
-	Real currMax = std::numeric_limits<Real>::lowest();
-	Real potentialMaxDot;
-
-	potentialMaxDot = direction.dot<2>( dirNw );
-	if ( potentialMaxDot > currMax )
-	{
-		currMax = potentialMaxDot;
-		point = dirNw;
-	}
-
-	potentialMaxDot = direction.dot<2>( dirSw );
-	if ( potentialMaxDot > currMax )
-	{
-		currMax = potentialMaxDot;
-		point = dirSw;
-	}
-
-	potentialMaxDot = direction.dot<2>( dirSe );
-	if ( potentialMaxDot > currMax )
-	{
-		currMax = potentialMaxDot;
-		point = dirSe;
-	}
-
-	potentialMaxDot = direction.dot<2>( dirNe );
-	if ( potentialMaxDot > currMax )
-	{
-		currMax = potentialMaxDot;
-		point = dirNe;
-	}
+	return getAabb( Rotation( rot ) );
 }
 
-physicsAabb physicsBoxShape::getAabb( const Real rot ) const
+physicsAabb physicsBoxShape::getAabb( const Rotation& rotation ) const
 {
-	// ERROR: this shouldn't have to convert to radians
-	Real radians = rot * ( Real )M_PI / 180.0f;
-	Real w = 2.0f * m_halfExtents( 0 ) * cos( radians ) + 2.0f * m_halfExtents( 1 ) * sin( radians );
-	Real h = 2.0f * m_halfExtents( 0 ) * sin( radians ) + 2.0f * m_halfExtents( 1 ) * cos( radians );
+	// Half extents of rotated box, absolute cos and sin cover every quadrant
+	const Real c = fabs( rotation.getCos() );
+	const Real s = fabs( rotation.getSin() );
+	const Real w = m_halfExtents( 0 ) * c + m_halfExtents( 1 ) * s;
+	const Real h = m_halfExtents( 0 ) * s + m_halfExtents( 1 ) * c;
 
 	return physicsAabb(
-		Vector4( w / 2.0f, h / 2.0f ),
-		Vector4( -w / 2.0f, -h / 2.0f ) );
+		Vector4( w, h ),
+		Vector4( -w, -h ) );
 }
 
 // Convex shape class functions
@@ -198,10 +161,22 @@ physicsConvexShape::physicsConvexShape( const std::vector<Vector4>& vertices, co
 
 	// TODO: Bug where code will fail if two same vertices exist in vertices array
 	int numVertices = ( int )vertices.size();
+	Assert( numVertices <= ( 1 << EDGE_VERTEX_BITS ), "too many vertices to identify edges by" );
 
 	// TODO: APPLY CONVEX RADIUS
 	m_vertices.assign( vertices.begin(), vertices.end() );
 
+	const int numPadded = ( numVertices + physicsKernels::MAX_WIDTH - 1 ) / physicsKernels::MAX_WIDTH * physicsKernels::MAX_WIDTH;
+	m_vertexXs.resize( numPadded );
+	m_vertexYs.resize( numPadded );
+
+	for ( int i = 0; i < numPadded; i++ )
+	{
+		const Vector4& vertex = m_vertices[i < numVertices ? i : 0];
+		m_vertexXs[i] = vertex( 0 );
+		m_vertexYs[i] = vertex( 1 );
+	}
+
 	// Determine connectivity
 	unsigned int xMinIdx = 0;
 
@@ -311,28 +286,23 @@ bool physicsConvexShape::containsPoint( const Vector4& point ) const
 	return true;
 }
 
-void physicsConvexShape::getSupportingVertex( const Vector4& direction, Vector4& point ) const
+void physicsConvexShape::getSupportingVertex( const Vector4& direction, Vector4& point, FeatureId& feature ) const
 {
-	Real dotMax = std::numeric_limits<Real>::lowest();
-	Real potentialMaxDot;
-
-	auto numVertices = m_vertices.size();
-
 	Vector4 dirNorm = direction.getNormalized<2>();
 
-	for ( auto i = 0; i < numVertices; i++ )
-	{
-		potentialMaxDot = dirNorm.dot<2>( m_vertices[i] );
+	const int vertexIdx = physicsKernels::get().findSupportingVertex(
+		m_vertexXs.data(), m_vertexYs.data(), ( int )m_vertices.size(), dirNorm( 0 ), dirNorm( 1 ) );
 
-		if ( potentialMaxDot > dotMax )
-		{
-			dotMax = potentialMaxDot;
-			point = m_vertices[i];
-		}
-	}
+	point = m_vertices[vertexIdx];
+	feature = VERTEX_FEATURE | static_cast< FeatureId >( vertexIdx );
 }
 
 physicsAabb physicsConvexShape::getAabb( const Real rot ) const
+{
+	return getAabb( Rotation( rot ) );
+}
+
+physicsAabb physicsConvexShape::getAabb( const Rotation& rotation ) const
 {
 	Real xmin, xmax, ymin, ymax;
 
@@ -342,7 +312,7 @@ physicsAabb physicsConvexShape::getAabb( const Real rot ) const
 	auto numVertices = m_vertices.size();
 	for ( auto i = 0; i < numVertices; i++ )
 	{
-		Vector4 vertW = m_vertices[i].getRotatedDir( rot );
+		Vector4 vertW = m_vertices[i].getRotatedDir( rotation );
 		xmin = std::min( vertW( 0 ), xmin );
 		xmax = std::max( vertW( 0 ), xmax );
 		ymin = std::min( vertW( 1 ), ymin );
@@ -2,12 +2,16 @@
 
 #include <memory>
 #include <vector>
+#include <limits>
+#include <algorithm>
 #include <Base.h>
 #include <physicsObject.h>
+#include <physicsTypes.h>
 
 class physicsAabb;
 
 // Base class for all shapes
+// Concrete shapes are final, calls through a concrete shape type are resolved at compile time
 class physicsShape : public physicsObject
 {
 public:
@@ -20,6 +24,14 @@ public:
         CONVEX,
 		NUM_SHAPES
     };
+
+	// Feature identifiers are the feature index tagged with its kind,
+	// used to match contacts between frames
+	static const FeatureId VERTEX_FEATURE = 0x0000;
+	static const FeatureId EDGE_FEATURE = 0x8000;
+
+	// Edges are identified by their two vertex indices, 7 bits each
+	static const int EDGE_VERTEX_BITS = 7;
 	
 	Real m_convexRadius;
 
@@ -37,13 +49,18 @@ public:
 
     virtual bool containsPoint(const Vector4& point) const = 0;
 
-    virtual void getSupportingVertex(const Vector4& direction, Vector4& point) const = 0;
+	// Feature is the supporting vertex, or the whole boundary of smooth shapes
+    virtual void getSupportingVertex(const Vector4& direction, Vector4& point, FeatureId& feature) const = 0;
 
     virtual physicsAabb getAabb(const Real rot) const = 0;
+
+	// Feature spanned by two supporting features, the feature itself when both are the same,
+	// otherwise the edge between both vertices, whichever order they're given in
+	static inline FeatureId getSpannedFeatureId( const FeatureId featureA, const FeatureId featureB );
 };
 
 // Circle shape
-class physicsCircleShape : public physicsShape
+class physicsCircleShape final : public physicsShape
 {
 public:
 
@@ -59,7 +76,7 @@ public:
  
     virtual bool containsPoint(const Vector4& point) const override;
 
-    virtual void getSupportingVertex(const Vector4& direction, Vector4& point) const override;
+    inline virtual void getSupportingVertex(const Vector4& direction, Vector4& point, FeatureId& feature) const override;
 
     virtual physicsAabb getAabb(const Real rot) const override;
 
@@ -73,7 +90,7 @@ protected:
 };
 
 // Box shape
-class physicsBoxShape : public physicsShape
+class physicsBoxShape final : public physicsShape
 {
 public:
 
@@ -89,10 +106,14 @@ public:
 
 	virtual bool containsPoint( const Vector4& point ) const override;
 
-	virtual void getSupportingVertex( const Vector4& direction, Vector4& point ) const override;
+	// Vertices are numbered counter-clockwise from +x +y
+	inline virtual void getSupportingVertex( const Vector4& direction, Vector4& point, FeatureId& feature ) const override;
 
 	virtual physicsAabb getAabb( const Real rot ) const override;
 
+	// Same as getAabb( rot ), rotation given as cos and sin
+	physicsAabb getAabb( const Rotation& rotation ) const;
+
 	const Vector4& getHalfExtents() const { return m_halfExtents; }
     
 protected:
@@ -103,7 +124,7 @@ protected:
 };
 
 // Convex shape
-class physicsConvexShape : public physicsShape
+class physicsConvexShape final : public physicsShape
 {
 public:
 
@@ -119,10 +140,14 @@ public:
 
     virtual bool containsPoint(const Vector4& point) const override;
 
-    virtual void getSupportingVertex(const Vector4& direction, Vector4& point) const override;
+	// Vertices are numbered as in getVertices
+    virtual void getSupportingVertex(const Vector4& direction, Vector4& point, FeatureId& feature) const override;
 
     virtual physicsAabb getAabb(const Real rot) const override;
 
+	// Same as getAabb( rot ), rotation given as cos and sin
+	physicsAabb getAabb( const Rotation& rotation ) const;
+
 	bool getAdjacentVertices( const Vector4& vertex, Vector4& va, Vector4& vb );
 
 	const std::vector<Vector4>& getVertices() const { return m_vertices; }
@@ -141,5 +166,11 @@ protected:
 
     std::vector<Vector4> m_vertices;
 
+	// Coordinates of m_vertices for support scans, padded for kernels as told in physicsKernelTable
+	std::vector<Real> m_vertexXs;
+	std::vector<Real> m_vertexYs;
+
     std::vector<int> m_connectivity; // Wraps towards the end
 };
+
+#include <physicsShape.inl>
@@ -0,0 +1,65 @@
+//
+// Support mapping of simple shapes, defined here so typed colliders can inline it
+inline FeatureId physicsShape::getSpannedFeatureId( const FeatureId featureA, const FeatureId featureB )
+{
+	if ( featureA == featureB )
+	{
+		return featureA;
+	}
+
+	const FeatureId lower = std::min( featureA, featureB );
+	const FeatureId upper = std::max( featureA, featureB );
+
+	return EDGE_FEATURE | static_cast< FeatureId >( ( lower << EDGE_VERTEX_BITS ) | upper );
+}
+
+inline void physicsCircleShape::getSupportingVertex( const Vector4& direction, Vector4& point, FeatureId& feature ) const
+{
+	point.setMul( direction.getNormalized<2>(), m_radius );
+
+	// Circle boundary is a single smooth feature
+	feature = EDGE_FEATURE;
+}
+
+inline void physicsBoxShape::getSupportingVertex( const Vector4& direction, Vector4& point, FeatureId& feature ) const
+{
+	Vector4 dirNw( -m_halfExtents( 0 ), m_halfExtents( 1 ) );
+	Vector4 dirSw( -m_halfExtents( 0 ), -m_halfExtents( 1 ) );
+	Vector4 dirSe( m_halfExtents( 0 ), -m_halfExtents( 1 ) );
+	Vector4 dirNe( m_halfExtents( 0 ), m_halfExtents( 1 ) );
+
+	Real currMax = std::numeric_limits<Real>::lowest();
+	Real potentialMaxDot;
+
+	potentialMaxDot = direction.dot<2>( dirNw );
+	if ( potentialMaxDot > currMax )
+	{
+		currMax = potentialMaxDot;
+		point = dirNw;
+		feature = VERTEX_FEATURE | 1;
+	}
+
+	potentialMaxDot = direction.dot<2>( dirSw );
+	if ( potentialMaxDot > currMax )
+	{
+		currMax = potentialMaxDot;
+		point = dirSw;
+		feature = VERTEX_FEATURE | 2;
+	}
+
+	potentialMaxDot = direction.dot<2>( dirSe );
+	if ( potentialMaxDot > currMax )
+	{
+		currMax = potentialMaxDot;
+		point = dirSe;
+		feature = VERTEX_FEATURE | 3;
+	}
+
+	potentialMaxDot = direction.dot<2>( dirNe );
+	if ( potentialMaxDot > currMax )
+	{
+		currMax = potentialMaxDot;
+		point = dirNe;
+		feature = VERTEX_FEATURE | 0;
+	}
+}
@@ -0,0 +1,154 @@
+#include <cstring>
+#include <functional>
+
+#include <Base.h>
+#include <physicsShapeRegistry.h>
+
+static void combineHash( size_t& hash, const Real value )
+{
+	hash ^= std::hash<Real>()( value ) + 0x9e3779b9 + ( hash << 6 ) + ( hash >> 2 );
+}
+
+static bool isEqualXY( const Vector4& a, const Vector4& b )
+{
+	return ( a( 0 ) == b( 0 ) && a( 1 ) == b( 1 ) );
+}
+
+physicsShapeRegistry::physicsShapeRegistry()
+{
+
+}
+
+ShapeId physicsShapeRegistry::intern( const physicsShape& shape )
+{
+	const size_t hash = calculateHash( shape );
+	auto range = m_shapeIds.equal_range( hash );
+
+	for ( auto iter = range.first; iter != range.second; iter++ )
+	{
+		if ( isEqual( shape, iter->second ) )
+		{
+			return iter->second;
+		}
+	}
+
+	ShapeId shapeId = invalidShapeId;
+
+	switch ( shape.getType() )
+	{
+	case physicsShape::CIRCLE:
+		shapeId = add( m_circles, shape );
+		break;
+	case physicsShape::BOX:
+		shapeId = add( m_boxes, shape );
+		break;
+	case physicsShape::CONVEX:
+		shapeId = add( m_convexes, shape );
+		break;
+	default:
+		Assert( false, "registering shape of unknown type" );
+		return invalidShapeId;
+	}
+
+	m_shapeIds.insert( std::make_pair( hash, shapeId ) );
+	return shapeId;
+}
+
+int physicsShapeRegistry::getNumShapes() const
+{
+	return ( int )( m_circles.size() + m_boxes.size() + m_convexes.size() );
+}
+
+size_t physicsShapeRegistry::calculateHash( const physicsShape& shape )
+{
+	size_t hash = std::hash<int>()( shape.getType() );
+	combineHash( hash, shape.m_convexRadius );
+
+	switch ( shape.getType() )
+	{
+	case physicsShape::CIRCLE:
+		combineHash( hash, static_cast< const physicsCircleShape& >( shape ).getRadius() );
+		break;
+	case physicsShape::BOX:
+	{
+		const Vector4& halfExtents = static_cast< const physicsBoxShape& >( shape ).getHalfExtents();
+		combineHash( hash, halfExtents( 0 ) );
+		combineHash( hash, halfExtents( 1 ) );
+		break;
+	}
+	case physicsShape::CONVEX:
+	{
+		const std::vector<Vector4>& vertices = static_cast< const physicsConvexShape& >( shape ).getVertices();
+		for ( auto iter = vertices.begin(); iter != vertices.end(); iter++ )
+		{
+			combineHash( hash, ( *iter )( 0 ) );
+			combineHash( hash, ( *iter )( 1 ) );
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	return hash;
+}
+
+bool physicsShapeRegistry::isEqual( const physicsShape& shape, ShapeId shapeId ) const
+{
+	const physicsShape* registered = getShape( shapeId );
+
+	if ( shape.getType() != registered->getType() || shape.m_convexRadius != registered->m_convexRadius )
+	{
+		return false;
+	}
+
+	switch ( shape.getType() )
+	{
+	case physicsShape::CIRCLE:
+		return static_cast< const physicsCircleShape& >( shape ).getRadius() ==
+			static_cast< const physicsCircleShape* >( registered )->getRadius();
+	case physicsShape::BOX:
+		return isEqualXY( static_cast< const physicsBoxShape& >( shape ).getHalfExtents(),
+						  static_cast< const physicsBoxShape* >( registered )->getHalfExtents() );
+	case physicsShape::CONVEX:
+	{
+		const std::vector<Vector4>& vertices = static_cast< const physicsConvexShape& >( shape ).getVertices();
+		const std::vector<Vector4>& registeredVertices = static_cast< const physicsConvexShape* >( registered )->getVertices();
+
+		if ( vertices.size() != registeredVertices.size() )
+		{
+			return false;
+		}
+
+		for ( int i = 0; i < ( int )vertices.size(); i++ )
+		{
+			if ( !isEqualXY( vertices[i], registeredVertices[i] ) )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+template <typename ShapeType>
+ShapeId physicsShapeRegistry::add( std::vector<ShapeType>& pool, const physicsShape& shape )
+{
+	const physicsShape::Type type = shape.getType();
+	const int shapeIdx = ( int )pool.size();
+	Assert( shapeIdx < ( int )INDEX_MASK, "too many shapes" );
+
+	pool.push_back( static_cast< const ShapeType& >( shape ) );
+
+	physicsShapeProperties properties;
+	properties.mass = shape.calculateMass();
+	properties.inertia = shape.calculateInertia();
+	properties.localAabb = shape.getAabb( 0.f );
+	m_properties[type].push_back( properties );
+
+	return ( ShapeId )shapeIdx | ( ( ShapeId )type << INDEX_BITS );
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <physicsTypes.h>
+#include <physicsShape.h>
+#include <physicsAabb.h>
+
+// Properties of a shape calculated once when it is registered
+struct physicsShapeProperties
+{
+	Real mass;
+	Real inertia;
+	physicsAabb localAabb; // At zero rotation
+};
+
+// Shapes of a world, stored by value in one pool per shape type
+// Registering a shape equal in type and parameters to a registered one returns the existing shape's id,
+// so crowds of bodies made from copies of a shape share one entry
+// Shapes are kept for the lifetime of the registry, pointers to them stay valid until the next registration
+class physicsShapeRegistry
+{
+public:
+
+	physicsShapeRegistry();
+
+	// Returns id of registered shape equal to shape, registering a copy of it if there is none
+	ShapeId intern( const physicsShape& shape );
+
+	inline const physicsShape* getShape( ShapeId shapeId ) const;
+
+	// Shape as its concrete type, calls on it don't go through the vtable
+	// ShapeType has to match type of shapeId
+	template <typename ShapeType>
+	inline const ShapeType& getTypedShape( ShapeId shapeId ) const;
+
+	inline const physicsShapeProperties& getProperties( ShapeId shapeId ) const;
+
+	int getNumShapes() const;
+
+	static physicsShape::Type getType( ShapeId shapeId ) { return ( physicsShape::Type )( shapeId >> INDEX_BITS ); }
+
+private:
+
+	// Handle is index into its type's pool in low bits and shape type in high bits
+	static const int INDEX_BITS = 24;
+	static const ShapeId INDEX_MASK = ( 1u << INDEX_BITS ) - 1;
+
+	static size_t calculateHash( const physicsShape& shape );
+
+	bool isEqual( const physicsShape& shape, ShapeId shapeId ) const;
+
+	template <typename ShapeType>
+	ShapeId add( std::vector<ShapeType>& pool, const physicsShape& shape );
+
+	std::vector<physicsCircleShape> m_circles;
+	std::vector<physicsBoxShape> m_boxes;
+	std::vector<physicsConvexShape> m_convexes;
+
+	// Indexed by shape type, then by index into the type's pool
+	std::vector<physicsShapeProperties> m_properties[physicsShape::NUM_SHAPES];
+
+	// Registered shapes by hash of type and parameters
+	std::unordered_multimap<size_t, ShapeId> m_shapeIds;
+};
+
+#include <physicsShapeRegistry.inl>
@@ -0,0 +1,43 @@
+inline const physicsShape* physicsShapeRegistry::getShape( ShapeId shapeId ) const
+{
+	const int shapeIdx = ( int )( shapeId & INDEX_MASK );
+
+	switch ( getType( shapeId ) )
+	{
+	case physicsShape::CIRCLE:
+		return &m_circles[shapeIdx];
+	case physicsShape::BOX:
+		return &m_boxes[shapeIdx];
+	case physicsShape::CONVEX:
+		return &m_convexes[shapeIdx];
+	default:
+		Assert( false, "invalid shape id" );
+		return nullptr;
+	}
+}
+
+inline const physicsShapeProperties& physicsShapeRegistry::getProperties( ShapeId shapeId ) const
+{
+	return m_properties[getType( shapeId )][shapeId & INDEX_MASK];
+}
+
+template <>
+inline const physicsCircleShape& physicsShapeRegistry::getTypedShape<physicsCircleShape>( ShapeId shapeId ) const
+{
+	Assert( getType( shapeId ) == physicsShape::CIRCLE, "shape id isn't a circle" );
+	return m_circles[shapeId & INDEX_MASK];
+}
+
+template <>
+inline const physicsBoxShape& physicsShapeRegistry::getTypedShape<physicsBoxShape>( ShapeId shapeId ) const
+{
+	Assert( getType( shapeId ) == physicsShape::BOX, "shape id isn't a box" );
+	return m_boxes[shapeId & INDEX_MASK];
+}
+
+template <>
+inline const physicsConvexShape& physicsShapeRegistry::getTypedShape<physicsConvexShape>( ShapeId shapeId ) const
+{
+	Assert( getType( shapeId ) == physicsShape::CONVEX, "shape id isn't a convex" );
+	return m_convexes[shapeId & INDEX_MASK];
+}
@@ -0,0 +1,259 @@
+#include <algorithm>
+
+#include <Base.h>
+#include <physicsTypes.h>
+#include <physicsBody.h>
+#include <physicsSolver.h>
+#include <physicsSimdSolver.h>
+
+void physicsSimdSolver::buildBatches(
+	const SolverInfo& info,
+	bool isContact,
+	int width,
+	std::vector<ConstrainedPair>& constrainedPairs,
+	const std::vector<SolverBody>& solverBodies )
+{
+	const int W = width;
+
+	m_lastBatch.assign( solverBodies.size(), -1 );
+	m_numLanes.clear();
+	m_constraintRowIdx.clear();
+
+	// Put each row in the earliest open batch after the last batch touching its dynamic bodies,
+	// this keeps rows of every body in their original order. Static bodies are never written to,
+	// so they don't conflict
+	int firstOpenBatch = 0;
+
+	for ( auto pairIdx = 0; pairIdx < constrainedPairs.size(); pairIdx++ )
+	{
+		const ConstrainedPair& pair = constrainedPairs[pairIdx];
+		const bool dynamicA = solverBodies[pair.solverBodyIdxA].isDynamic();
+		const bool dynamicB = solverBodies[pair.solverBodyIdxB].isDynamic();
+
+		for ( auto constraintIdx = 0; constraintIdx < pair.constraints.size(); constraintIdx++ )
+		{
+			int batchIdx = firstOpenBatch;
+			if ( dynamicA ) batchIdx = std::max( batchIdx, m_lastBatch[pair.solverBodyIdxA] + 1 );
+			if ( dynamicB ) batchIdx = std::max( batchIdx, m_lastBatch[pair.solverBodyIdxB] + 1 );
+
+			while ( batchIdx < ( int )m_numLanes.size() && m_numLanes[batchIdx] == W )
+			{
+				batchIdx++;
+			}
+
+			if ( batchIdx == ( int )m_numLanes.size() )
+			{
+				m_numLanes.push_back( 0 );
+			}
+
+			int lane = m_numLanes[batchIdx]++;
+
+			while ( firstOpenBatch < ( int )m_numLanes.size() && m_numLanes[firstOpenBatch] == W )
+			{
+				firstOpenBatch++;
+			}
+
+			if ( dynamicA ) m_lastBatch[pair.solverBodyIdxA] = batchIdx;
+			if ( dynamicB ) m_lastBatch[pair.solverBodyIdxB] = batchIdx;
+
+			m_constraintRowIdx.push_back( batchIdx * W + lane );
+		}
+	}
+
+	const int numBatches = ( int )m_numLanes.size();
+	const int numRows = numBatches * W;
+
+	// Padded lanes point to shared static body and never produce impulse
+	for ( std::vector<Real>* field : { &m_jvAx, &m_jvAy, &m_jwA, &m_jvBx, &m_jvBy, &m_jwB,
+									   &m_mjvAx, &m_mjvAy, &m_mjwA, &m_mjvBx, &m_mjvBy, &m_mjwB,
+									   &m_invEffMass, &m_JmJ, &m_biasVel, &m_lower, &m_upper, &m_friction, &m_isFriction } )
+	{
+		field->assign( numRows, 0.f );
+	}
+
+	m_bodyIdxA.assign( numRows, SolverBody::STATIC_BODY_IDX );
+	m_bodyIdxB.assign( numRows, SolverBody::STATIC_BODY_IDX );
+	m_normalRowIdx.resize( numRows );
+	for ( int rowIdx = 0; rowIdx < numRows; rowIdx++ )
+	{
+		m_normalRowIdx[rowIdx] = rowIdx;
+	}
+
+	m_accumImp.assign( numRows, 0.f );
+	m_rowConstraints.assign( numRows, nullptr );
+
+	// Bake constants of each row
+	// Split impulse corrects position error after velocities are solved
+	const Real bias = ( info.m_numPositionIter > 0 ) ? 0.f : ( isContact ? info.m_contactBias : info.m_jointBias );
+	int pairRowBase = 0;
+
+	for ( auto pairIdx = 0; pairIdx < constrainedPairs.size(); pairIdx++ )
+	{
+		ConstrainedPair& pair = constrainedPairs[pairIdx];
+		const SolverBody& bodyA = solverBodies[pair.solverBodyIdxA];
+		const SolverBody& bodyB = solverBodies[pair.solverBodyIdxB];
+
+		for ( auto constraintIdx = 0; constraintIdx < pair.constraints.size(); constraintIdx++ )
+		{
+			Constraint& constraint = pair.constraints[constraintIdx];
+			const Jacobian& jac = constraint.jac;
+
+			const int rowIdx = m_constraintRowIdx[pairRowBase + constraintIdx];
+
+			m_bodyIdxA[rowIdx] = pair.solverBodyIdxA;
+			m_bodyIdxB[rowIdx] = pair.solverBodyIdxB;
+
+			m_jvAx[rowIdx] = jac.vA( 0 );
+			m_jvAy[rowIdx] = jac.vA( 1 );
+			m_jwA[rowIdx] = jac.wA( 2 );
+			m_jvBx[rowIdx] = jac.vB( 0 );
+			m_jvBy[rowIdx] = jac.vB( 1 );
+			m_jwB[rowIdx] = jac.wB( 2 );
+
+			m_mjvAx[rowIdx] = jac.vA( 0 ) * bodyA.mInv;
+			m_mjvAy[rowIdx] = jac.vA( 1 ) * bodyA.mInv;
+			m_mjwA[rowIdx] = jac.wA( 2 ) * bodyA.iInv;
+			m_mjvBx[rowIdx] = jac.vB( 0 ) * bodyB.mInv;
+			m_mjvBy[rowIdx] = jac.vB( 1 ) * bodyB.mInv;
+			m_mjwB[rowIdx] = jac.wB( 2 ) * bodyB.iInv;
+
+			Real JmJ =
+				jac.vA( 0 ) * bodyA.mInv * jac.vA( 0 ) +
+				jac.vA( 1 ) * bodyA.mInv * jac.vA( 1 ) +
+				jac.wA( 2 ) * bodyA.iInv * jac.wA( 2 ) +
+				jac.vB( 0 ) * bodyB.mInv * jac.vB( 0 ) +
+				jac.vB( 1 ) * bodyB.mInv * jac.vB( 1 ) +
+				jac.wB( 2 ) * bodyB.iInv * jac.wB( 2 );
+
+			m_invEffMass[rowIdx] = ( JmJ > 0.f ) ? 1.f / JmJ : 0.f;
+			m_JmJ[rowIdx] = JmJ;
+			// Separated rows of split impulse still allow closing the gap
+			Real biasVel = bias * constraint.error / info.m_deltaTime;
+			if ( constraint.type == Constraint::MOTOR )
+			{
+				biasVel = constraint.error;
+			}
+			else if ( constraint.type == Constraint::CONTACT && constraint.error < 0.f && info.m_numPositionIter > 0 )
+			{
+				biasVel = constraint.error / info.m_deltaTime;
+			}
+
+			m_biasVel[rowIdx] = biasVel;
+
+			if ( constraint.type == Constraint::CONTACT )
+			{
+				m_lower[rowIdx] = 0.f;
+				m_upper[rowIdx] = FLT_MAX;
+			}
+			else if ( constraint.type == Constraint::FRICTION )
+			{
+				m_friction[rowIdx] = constraint.friction;
+				m_isFriction[rowIdx] = 1.f;
+				m_normalRowIdx[rowIdx] = m_constraintRowIdx[pairRowBase + constraint.normalIdx];
+			}
+			else if ( constraint.type == Constraint::MOTOR )
+			{
+				m_lower[rowIdx] = -constraint.friction;
+				m_upper[rowIdx] = constraint.friction;
+			}
+			else
+			{
+				m_lower[rowIdx] = -FLT_MAX;
+				m_upper[rowIdx] = FLT_MAX;
+			}
+
+			m_accumImp[rowIdx] = constraint.accumImp;
+			m_rowConstraints[rowIdx] = &constraint;
+		}
+
+		pairRowBase += ( int )pair.constraints.size();
+	}
+
+	updateRowView( W, numBatches );
+}
+
+void physicsSimdSolver::updateRowView( int width, int numBatches )
+{
+	m_rows.width = width;
+	m_rows.numBatches = numBatches;
+
+	m_rows.jvAx = m_jvAx.data();
+	m_rows.jvAy = m_jvAy.data();
+	m_rows.jwA = m_jwA.data();
+	m_rows.jvBx = m_jvBx.data();
+	m_rows.jvBy = m_jvBy.data();
+	m_rows.jwB = m_jwB.data();
+
+	m_rows.mjvAx = m_mjvAx.data();
+	m_rows.mjvAy = m_mjvAy.data();
+	m_rows.mjwA = m_mjwA.data();
+	m_rows.mjvBx = m_mjvBx.data();
+	m_rows.mjvBy = m_mjvBy.data();
+	m_rows.mjwB = m_mjwB.data();
+
+	m_rows.invEffMass = m_invEffMass.data();
+	m_rows.JmJ = m_JmJ.data();
+	m_rows.biasVel = m_biasVel.data();
+	m_rows.lower = m_lower.data();
+	m_rows.upper = m_upper.data();
+	m_rows.friction = m_friction.data();
+	m_rows.isFriction = m_isFriction.data();
+
+	m_rows.bodyIdxA = m_bodyIdxA.data();
+	m_rows.bodyIdxB = m_bodyIdxB.data();
+	m_rows.normalRowIdx = m_normalRowIdx.data();
+}
+
+void physicsSimdSolver::solveConstraints(
+	const SolverInfo& info,
+	bool isContact,
+	std::vector<ConstrainedPair>& constrainedPairs,
+	std::vector<SolverBody>& solverBodies )
+{
+	if ( constrainedPairs.empty() )
+	{
+		return;
+	}
+
+	const physicsKernelTable& kernels = physicsKernels::get();
+	buildBatches( info, isContact, kernels.width, constrainedPairs, solverBodies );
+
+	const int numRows = m_rows.numBatches * m_rows.width;
+
+	// Warm start with impulses accumulated in previous step
+	for ( int rowIdx = 0; rowIdx < numRows; rowIdx++ )
+	{
+		const Constraint* constraint = m_rowConstraints[rowIdx];
+
+		if ( constraint == nullptr )
+		{
+			continue;
+		}
+
+		SolverBody& bodyA = solverBodies[m_bodyIdxA[rowIdx]];
+		SolverBody& bodyB = solverBodies[m_bodyIdxB[rowIdx]];
+		const Jacobian& jac = constraint->jac;
+
+		bodyA.applyImpulse( jac.vA, jac.wA, m_accumImp[rowIdx] );
+		bodyB.applyImpulse( jac.vB, jac.wB, m_accumImp[rowIdx] );
+	}
+
+	for ( int iter = 0; iter < info.m_numIter; iter++ )
+	{
+		const Real residual = kernels.solveRowBatches( m_rows, m_accumImp.data(), solverBodies.data() );
+
+		if ( iter + 1 >= info.m_minIter && residual <= info.m_velocityTolerance )
+		{
+			break;
+		}
+	}
+
+	// Store accumulated impulses back for caching
+	for ( int i = 0; i < ( int )m_rowConstraints.size(); i++ )
+	{
+		if ( m_rowConstraints[i] )
+		{
+			m_rowConstraints[i]->accumImp = m_accumImp[i];
+		}
+	}
+}
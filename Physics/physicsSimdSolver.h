@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <physicsSolver.h>
+#include <physicsKernels.h>
+
+// Projected Gauss-Seidel solver working on batches of constraint rows
+// Batches are as wide as the vectors of the kernels picked for the CPU, see physicsKernels
+// Effective masses and world space jacobians are baked once per solve
+class physicsSimdSolver
+{
+public:
+
+	void solveConstraints(
+		const SolverInfo& info,
+		bool isContact,
+		std::vector<ConstrainedPair>& constrainedPairs,
+		std::vector<SolverBody>& solverBodies
+	);
+
+private:
+
+	// Distribute rows into batches of given width and bake per row constants
+	void buildBatches(
+		const SolverInfo& info,
+		bool isContact,
+		int width,
+		std::vector<ConstrainedPair>& constrainedPairs,
+		const std::vector<SolverBody>& solverBodies
+	);
+
+	// Point m_rows at row arrays, after they're sized
+	void updateRowView( int width, int numBatches );
+
+	// Row constants in structure-of-arrays layout, indexed by row index ( batch index * width + lane )
+	// See SimdRowBatches for what each holds
+	std::vector<Real> m_jvAx, m_jvAy, m_jwA, m_jvBx, m_jvBy, m_jwB;
+	std::vector<Real> m_mjvAx, m_mjvAy, m_mjwA, m_mjvBx, m_mjvBy, m_mjwB;
+	std::vector<Real> m_invEffMass, m_JmJ, m_biasVel, m_lower, m_upper, m_friction, m_isFriction;
+	std::vector<int> m_bodyIdxA, m_bodyIdxB, m_normalRowIdx;
+
+	SimdRowBatches m_rows;
+
+	// Accumulated impulses, indexed by row index
+	std::vector<Real> m_accumImp;
+
+	// Constraint each row was built from, nullptr for padded lanes
+	std::vector<Constraint*> m_rowConstraints;
+
+	// Scratch used while batching
+	std::vector<int> m_numLanes;
+	std::vector<int> m_lastBatch;
+	std::vector<int> m_constraintRowIdx;
+};
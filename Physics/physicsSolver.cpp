@@ -1,119 +1,871 @@
 #include <algorithm>
+#include <atomic>
 
 #include <Base.h>
 #include <physicsTypes.h>
 #include <physicsBody.h>
 #include <physicsSolver.h>
+#include <physicsSimdSolver.h>
+#include <physicsDirectSolver.h>
+#include <physicsThreadPool.h>
 
 #include <DebugUtils.h>
 
-/*
-{ // Add friction
-	Constraint friction;
-	friction.rA = contactPoint.getContactA();
-	friction.rB = contactPoint.getContactB();
-	friction.accumImp = 0.f;
-	friction.error = 0.f;
+// Colors available to graph coloring, pairs which don't fit go to one extra color solved serially
+const int g_maxColors = 64;
 
-	const Vector3& n = contactPoint.getNormal().getRotatedDir( 90.f * g_degToRad );
-	const SolverBody& bodyA = getSolverBody( constrainedPair.bIdA );
-	const SolverBody& bodyB = getSolverBody( constrainedPair.bIdB );
-	const Vector3& rA_world = friction.rA.getRotatedDir( bodyA.ori );
-	const Vector3& rB_world = friction.rB.getRotatedDir( bodyB.ori );
+// Smallest number of pairs handed to a thread at once
+const int g_minPairsPerTask = 64;
 
-	friction.jac.vA = n;
-	friction.jac.vB = n.getNegated();
-	friction.jac.wA = rA_world.cross( n );
-	friction.jac.wB = rB_world.cross( n.getNegated() );
+// Smallest number of bodies handed to a thread at once when averaging split bodies
+const int g_minBodiesPerTask = 256;
 
-	constrainedPair.constraints.push_back( friction );
+// Two point manifolds with K worse conditioned than this are solved row by row
+const Real g_maxBlockConditionNumber = 1000.f;
+
+const int SolverBody::STATIC_BODY_IDX;
+
+void SolverBody::setStatic()
+{
+	v.setZero();
+	w.setZero();
+	dp.setZero();
+	dRot = 0.f;
+	mInv = 0.f;
+	iInv = 0.f;
 }
-*/
 
-void SolverBody::setFromBody( const physicsBody& body )
+// Bias and softening of a constraint acting as a damped spring
+// Stiffer than the substep rate can resolve is clamped by the caller
+struct SoftCoefficients
 {
-	v = body.getLinearVelocity();
-	w( 2 ) = body.getAngularSpeed();
-	pos = body.getPosition();
-	ori = body.getRotation();
-	mInv = body.getInvMass();
-	iInv = body.getInvInertia();
+	Real biasRate;
+	Real massScale;
+	Real impulseScale;
+};
+
+void calcSoftCoefficients( const Real hertz, const Real dampingRatio, const Real h, SoftCoefficients& coeffsOut )
+{
+	const Real omega = 2.f * ( Real )M_PI * hertz;
+	const Real a1 = 2.f * dampingRatio + h * omega;
+	const Real a2 = h * omega * a1;
+	const Real a3 = 1.f / ( 1.f + a2 );
+
+	coeffsOut.biasRate = omega / a1;
+	coeffsOut.massScale = a2 * a3;
+	coeffsOut.impulseScale = a3;
 }
 
-void solveConstrainedPairs( const SolverInfo& info, 
-							bool isContact,
-							std::vector<ConstrainedPair>& solvePairs,
-							std::vector<SolverBody>& updatedBodiesOut )
+// Bake constants of pair's constraints which don't change over iterations
+// Rows act on bodies[bodyIdxA] and bodies[bodyIdxB], the pair's solver bodies or copies of them
+// Contact rows of two point manifolds are paired up into a block
+void prepareConstrainedPair( const SolverInfo& info,
+							 bool isContact,
+							 const ConstrainedPair& pair,
+							 const int bodyIdxA,
+							 const int bodyIdxB,
+							 const std::vector<SolverBody>& bodies,
+							 std::vector<SolverRow>& rowsOut,
+							 std::vector<SolverBlock>& blocksOut )
 {
-	for ( auto pairIdx = 0; pairIdx < solvePairs.size(); pairIdx++ )
+	const SolverBody& bodyA = bodies[ bodyIdxA ];
+	const SolverBody& bodyB = bodies[ bodyIdxB ];
+	const std::vector<Constraint>& constraints = pair.constraints;
+
+	const int firstRowIdx = ( int )rowsOut.size();
+
+	// Rigid rows correct a fraction of the error per step, either through velocity or split impulse
+	const Real bias = isContact ? info.m_contactBias : info.m_jointBias;
+	const bool splitImpulse = ( info.m_numPositionIter > 0 && info.m_numSubsteps <= 1 );
+
+	SoftCoefficients coeffs;
+	coeffs.biasRate = splitImpulse ? 0.f : bias / info.m_deltaTime;
+	coeffs.massScale = 1.f;
+	coeffs.impulseScale = 0.f;
+
+	if ( info.m_numSubsteps > 1 )
+	{
+		const Real h = info.m_deltaTime / info.m_numSubsteps;
+
+		// Contacts stiffer than a quarter of substep rate overshoot
+		const Real hertz = isContact ? std::min( info.m_contactHertz, .25f / h ) : info.m_jointHertz;
+		const Real dampingRatio = isContact ? info.m_contactDampingRatio : info.m_jointDampingRatio;
+		calcSoftCoefficients( hertz, dampingRatio, h, coeffs );
+	}
+
+	for ( auto constraintIdx = 0; constraintIdx < constraints.size(); constraintIdx++ )
+	{
+		const Constraint& constraint = constraints[ constraintIdx ];
+		const Jacobian& jac = constraint.jac;
+
+		Real JmJ =
+			jac.vA( 0 ) * bodyA.mInv * jac.vA( 0 ) +
+			jac.vA( 1 ) * bodyA.mInv * jac.vA( 1 ) +
+			jac.wA( 2 ) * bodyA.iInv * jac.wA( 2 ) +
+			jac.vB( 0 ) * bodyB.mInv * jac.vB( 0 ) +
+			jac.vB( 1 ) * bodyB.mInv * jac.vB( 1 ) +
+			jac.wB( 2 ) * bodyB.iInv * jac.wB( 2 );
+
+		SolverRow row;
+		row.jac = jac;
+		row.invEffMass = ( JmJ > 0.f ) ? 1.f / JmJ : 0.f;
+		row.JmJ = JmJ;
+		row.error = constraint.error;
+		row.accumImp = constraint.accumImp;
+		row.accumPositionImp = 0.f;
+		row.friction = constraint.friction;
+		row.type = constraint.type;
+		row.bodyIdxA = bodyIdxA;
+		row.bodyIdxB = bodyIdxB;
+		row.normalRowIdx = ( constraint.type == Constraint::FRICTION ) ? firstRowIdx + constraint.normalIdx : -1;
+		row.blockIdx = -1;
+
+		// Friction has no position error to correct and stays rigid, motors drive to the velocity in error
+		if ( constraint.type == Constraint::FRICTION || constraint.type == Constraint::MOTOR )
+		{
+			row.biasRate = ( constraint.type == Constraint::MOTOR ) ? 1.f : 0.f;
+			row.massScale = 1.f;
+			row.impulseScale = 0.f;
+			row.positionBias = 0.f;
+		}
+		else
+		{
+			row.biasRate = coeffs.biasRate;
+			row.massScale = coeffs.massScale;
+			row.impulseScale = coeffs.impulseScale;
+			row.positionBias = splitImpulse ? bias : 0.f;
+
+			// Velocity rows of split impulse have no bias, but separated rows still allow closing the gap
+			if ( splitImpulse && constraint.type == Constraint::CONTACT && constraint.error < 0.f )
+			{
+				row.biasRate = 1.f / info.m_deltaTime;
+				row.positionBias = 0.f;
+			}
+		}
+
+		Assert( !isinf( row.invEffMass ), "infinite effective mass in solver" );
+
+		rowsOut.push_back( row );
+	}
+
+	// Soft rows scale impulses per row and stay scalar
+	if ( !isContact || info.m_numSubsteps > 1 )
 	{
-		ConstrainedPair& pair = solvePairs[ pairIdx ];
+		return;
+	}
 
-		SolverBody& bodyA = updatedBodiesOut[ pair.bodyIdA ];
-		SolverBody& bodyB = updatedBodiesOut[ pair.bodyIdB ];
-		std::vector<Constraint>& constraints = pair.constraints;
+	int contactRowIdxs[2];
+	int numContactRows = 0;
 
-		for ( auto constraintIdx = 0; constraintIdx < constraints.size(); constraintIdx++ )
+	for ( int rowIdx = firstRowIdx; rowIdx < ( int )rowsOut.size(); rowIdx++ )
+	{
+		if ( rowsOut[rowIdx].type == Constraint::CONTACT )
 		{
-			Constraint& constraint = constraints[ constraintIdx ];
+			if ( numContactRows == 2 )
+			{
+				return;
+			}
+
+			contactRowIdxs[numContactRows++] = rowIdx;
+		}
+	}
 
-			Vector4 rA_world = constraint.rA.getRotatedDir( bodyA.ori ); // TODO: replace with transform
-			Vector4 rB_world = constraint.rB.getRotatedDir( bodyB.ori );
+	if ( numContactRows != 2 )
+	{
+		return;
+	}
+
+	SolverRow& row0 = rowsOut[contactRowIdxs[0]];
+	SolverRow& row1 = rowsOut[contactRowIdxs[1]];
+	const Jacobian& jac0 = row0.jac;
+	const Jacobian& jac1 = row1.jac;
 
-			const Jacobian& jac = constraint.jac;
+	const Real k01 =
+		jac0.vA( 0 ) * bodyA.mInv * jac1.vA( 0 ) +
+		jac0.vA( 1 ) * bodyA.mInv * jac1.vA( 1 ) +
+		jac0.wA( 2 ) * bodyA.iInv * jac1.wA( 2 ) +
+		jac0.vB( 0 ) * bodyB.mInv * jac1.vB( 0 ) +
+		jac0.vB( 1 ) * bodyB.mInv * jac1.vB( 1 ) +
+		jac0.wB( 2 ) * bodyB.iInv * jac1.wB( 2 );
 
-			Vector4 vab = bodyA.v + bodyA.w.cross( rA_world ) - bodyB.v - bodyB.w.cross( rB_world );
+	SolverBlock block;
+	block.K.set( row0.JmJ, k01, k01, row1.JmJ );
+	block.rowIdx0 = contactRowIdxs[0];
+	block.rowIdx1 = contactRowIdxs[1];
 
-			Real Jv = vab.dot<2>(jac.vA);
+	// Nearly parallel rows, e.g. points close together, make the direct solve unstable
+	const Real det = block.K.getDeterminant();
+	if ( row0.JmJ * row0.JmJ >= g_maxBlockConditionNumber * det || !block.invK.setInverse( block.K ) )
+	{
+		return;
+	}
 
-			Real JmJ =
-				jac.vA( 0 ) * bodyA.mInv * jac.vA( 0 ) +
-				jac.vA( 1 ) * bodyA.mInv * jac.vA( 1 ) +
-				jac.wA( 2 ) * bodyA.iInv * jac.wA( 2 ) +
-				jac.vB( 0 ) * bodyB.mInv * jac.vB( 0 ) +
-				jac.vB( 1 ) * bodyB.mInv * jac.vB( 1 ) +
-				jac.wB( 2 ) * bodyB.iInv * jac.wB( 2 );
+	row0.blockIdx = ( int )blocksOut.size();
+	row1.blockIdx = ( int )blocksOut.size();
+	blocksOut.push_back( block );
+}
 
-			Real bias = isContact ? 1.0f : 1.f;
+// Apply impulses accumulated in previous step before iterating
+void warmStartRows( const std::vector<SolverRow>& rows,
+					int beginRowIdx,
+					int endRowIdx,
+					std::vector<SolverBody>& updatedBodiesOut )
+{
+	for ( int rowIdx = beginRowIdx; rowIdx < endRowIdx; rowIdx++ )
+	{
+		const SolverRow& row = rows[ rowIdx ];
 
-			Real impulse = -1.f * ( Jv - bias*( constraint.error / info.m_deltaTime ) ) / JmJ;
+		updatedBodiesOut[ row.bodyIdxA ].applyImpulse( row.jac.vA, row.jac.wA, row.accumImp );
+		updatedBodiesOut[ row.bodyIdxB ].applyImpulse( row.jac.vB, row.jac.wB, row.accumImp );
+	}
+}
 
-			Assert( !isinf( impulse ), "infinite impulse in solver" );
-			Assert( !isnan( impulse ), "nan impulse in solver" );
+// Clamp accumulated impulse, return the difference to apply
+Real accumulateClampedImpulse( const std::vector<SolverRow>& rows, SolverRow& row, const Real impulse )
+{
+	Real newImpulse = row.accumImp + impulse;
 
-			if ( isContact )
-			{ 
-				Real newImpulse = std::max( pair.accumImp + impulse, 0.f );
-				impulse = newImpulse - pair.accumImp;
-				pair.accumImp = newImpulse;
+	if ( row.type == Constraint::CONTACT )
+	{ 
+		newImpulse = std::max( newImpulse, 0.f );
+	}
+	else if ( row.type == Constraint::FRICTION )
+	{
+		Real maxFriction = row.friction * rows[row.normalRowIdx].accumImp;
+		newImpulse = std::max( -maxFriction, std::min( newImpulse, maxFriction ) );
+	}
+	else if ( row.type == Constraint::MOTOR )
+	{
+		newImpulse = std::max( -row.friction, std::min( newImpulse, row.friction ) );
+	}
+
+	const Real appliedImpulse = newImpulse - row.accumImp;
+	row.accumImp = newImpulse;
+	return appliedImpulse;
+}
+
+// Solve a single row, returns its velocity change
+inline Real solveRow( std::vector<SolverRow>& rows,
+					  SolverRow& row,
+					  std::vector<SolverBody>& updatedBodiesOut )
+{
+	SolverBody& bodyA = updatedBodiesOut[ row.bodyIdxA ];
+	SolverBody& bodyB = updatedBodiesOut[ row.bodyIdxB ];
+	const Jacobian& jac = row.jac;
+
+	Real Jv =
+		jac.vA.dot<2>( bodyA.v ) + jac.wA( 2 ) * bodyA.w( 2 ) +
+		jac.vB.dot<2>( bodyB.v ) + jac.wB( 2 ) * bodyB.w( 2 );
+
+	Real impulse = -( Jv - row.biasRate * row.error ) * row.invEffMass;
+
+	Assert( !isinf( impulse ), "infinite impulse in solver" );
+	Assert( !isnan( impulse ), "nan impulse in solver" );
+
+	impulse = accumulateClampedImpulse( rows, row, impulse );
+
+	bodyA.applyImpulse( jac.vA, jac.wA, impulse );
+	bodyB.applyImpulse( jac.vB, jac.wB, impulse );
+
+	// TODO: clean-up these sanity checks
+	Assert( !bodyA.v.isInf(), "bodyA has infinite linear velocity in solver" );
+	Assert( !bodyB.v.isInf(), "bodyB has infinite linear velocity in solver" );
+	Assert( !bodyA.v.isNan(), "bodyA has nan linear velocity in solver" );
+	Assert( !bodyB.v.isNan(), "bodyB has nan linear velocity in solver" );
+	Assert( !bodyA.w.isInf(), "bodyA has infinite angular velocity in solver" );
+	Assert( !bodyB.w.isInf(), "bodyB has infinite angular velocity in solver" );
+	Assert( !bodyA.w.isNan(), "bodyA has nan angular velocity in solver" );
+	Assert( !bodyB.w.isNan(), "bodyB has nan angular velocity in solver" );
+
+	return fabs( impulse ) * row.JmJ;
+}
+
+// Solve both contact rows of a block at once by enumerating which of the two impulses are active,
+// i.e. find x >= 0 with K x + b >= 0 and complementarity, where b is relative velocity left at x = 0
+// Falls back to solving rows one by one if no case holds, returns largest velocity change
+Real solveContactBlock( std::vector<SolverRow>& rows,
+						const SolverBlock& block,
+						std::vector<SolverBody>& updatedBodiesOut )
+{
+	SolverRow& row0 = rows[ block.rowIdx0 ];
+	SolverRow& row1 = rows[ block.rowIdx1 ];
+	SolverBody& bodyA = updatedBodiesOut[ row0.bodyIdxA ];
+	SolverBody& bodyB = updatedBodiesOut[ row0.bodyIdxB ];
+	const Jacobian& jac0 = row0.jac;
+	const Jacobian& jac1 = row1.jac;
+
+	const Real Jv0 =
+		jac0.vA.dot<2>( bodyA.v ) + jac0.wA( 2 ) * bodyA.w( 2 ) +
+		jac0.vB.dot<2>( bodyB.v ) + jac0.wB( 2 ) * bodyB.w( 2 );
+	const Real Jv1 =
+		jac1.vA.dot<2>( bodyA.v ) + jac1.wA( 2 ) * bodyA.w( 2 ) +
+		jac1.vB.dot<2>( bodyB.v ) + jac1.wB( 2 ) * bodyB.w( 2 );
+
+	const Vector4 a( row0.accumImp, row1.accumImp );
+	const Vector4 b = Vector4( Jv0 - row0.biasRate * row0.error, Jv1 - row1.biasRate * row1.error ) - block.K.mul( a );
+
+	Vector4 x;
+	bool solved = false;
+
+	// Both points pushing
+	x = block.invK.mul( b ) * -1.f;
+	solved = ( x( 0 ) >= 0.f && x( 1 ) >= 0.f );
+
+	// Only first point pushing, second separating
+	if ( !solved )
+	{
+		x.set( -b( 0 ) / block.K( 0, 0 ), 0.f );
+		solved = ( x( 0 ) >= 0.f && block.K( 1, 0 ) * x( 0 ) + b( 1 ) >= 0.f );
+	}
+
+	// Only second point pushing, first separating
+	if ( !solved )
+	{
+		x.set( 0.f, -b( 1 ) / block.K( 1, 1 ) );
+		solved = ( x( 1 ) >= 0.f && block.K( 0, 1 ) * x( 1 ) + b( 0 ) >= 0.f );
+	}
+
+	// Both separating
+	if ( !solved )
+	{
+		x.setZero();
+		solved = ( b( 0 ) >= 0.f && b( 1 ) >= 0.f );
+	}
+
+	if ( !solved )
+	{
+		return std::max( solveRow( rows, row0, updatedBodiesOut ), solveRow( rows, row1, updatedBodiesOut ) );
+	}
+
+	const Vector4 d = x - a;
+
+	Assert( !d.isInf(), "infinite block impulse in solver" );
+	Assert( !d.isNan(), "nan block impulse in solver" );
+
+	row0.accumImp = x( 0 );
+	row1.accumImp = x( 1 );
+
+	bodyA.applyImpulse( jac0.vA, jac0.wA, d( 0 ) );
+	bodyB.applyImpulse( jac0.vB, jac0.wB, d( 0 ) );
+	bodyA.applyImpulse( jac1.vA, jac1.wA, d( 1 ) );
+	bodyB.applyImpulse( jac1.vB, jac1.wB, d( 1 ) );
+
+	return std::max( fabs( d( 0 ) ) * row0.JmJ, fabs( d( 1 ) ) * row1.JmJ );
+}
+
+// Returns largest velocity change of a row, used as residual for stopping early
+// Rows of a block are solved together when its first row is reached
+Real solveRows( std::vector<SolverRow>& rows,
+				const std::vector<SolverBlock>& blocks,
+				int beginRowIdx,
+				int endRowIdx,
+				std::vector<SolverBody>& updatedBodiesOut )
+{
+	Real maxResidual = 0.f;
+
+	for ( int rowIdx = beginRowIdx; rowIdx < endRowIdx; rowIdx++ )
+	{
+		SolverRow& row = rows[ rowIdx ];
+		Real residual = 0.f;
+
+		if ( row.blockIdx < 0 )
+		{
+			residual = solveRow( rows, row, updatedBodiesOut );
+		}
+		else if ( blocks[ row.blockIdx ].rowIdx0 == rowIdx )
+		{
+			residual = solveContactBlock( rows, blocks[ row.blockIdx ], updatedBodiesOut );
+		}
+
+		maxResidual = std::max( maxResidual, residual );
+	}
+
+	return maxResidual;
+}
+
+// Raise value to residual if larger, for ranges of rows solved in parallel
+void raiseResidual( std::atomic<Real>& value, const Real residual )
+{
+	Real current = value.load( std::memory_order_relaxed );
+
+	while ( residual > current && !value.compare_exchange_weak( current, residual, std::memory_order_relaxed ) )
+	{
+	}
+}
+
+// Split impulse iteration, moving position deltas of bodies to remove a fraction of each row's error
+// Impulses are in position units and never touch velocities, friction and motor rows are skipped
+void solvePositionRows( std::vector<SolverRow>& rows,
+						int beginRowIdx,
+						int endRowIdx,
+						std::vector<SolverBody>& updatedBodiesOut )
+{
+	for ( int rowIdx = beginRowIdx; rowIdx < endRowIdx; rowIdx++ )
+	{
+		SolverRow& row = rows[ rowIdx ];
+
+		if ( row.type == Constraint::FRICTION || row.type == Constraint::MOTOR )
+		{
+			continue;
+		}
+
+		SolverBody& bodyA = updatedBodiesOut[ row.bodyIdxA ];
+		SolverBody& bodyB = updatedBodiesOut[ row.bodyIdxB ];
+		const Jacobian& jac = row.jac;
+
+		Real Jdp =
+			jac.vA.dot<2>( bodyA.dp ) + jac.wA( 2 ) * bodyA.dRot +
+			jac.vB.dot<2>( bodyB.dp ) + jac.wB( 2 ) * bodyB.dRot;
+
+		Real impulse = -( Jdp - row.positionBias * row.error ) * row.invEffMass;
+
+		Assert( !isinf( impulse ), "infinite position impulse in solver" );
+		Assert( !isnan( impulse ), "nan position impulse in solver" );
+
+		Real newImpulse = row.accumPositionImp + impulse;
+		if ( row.type == Constraint::CONTACT )
+		{
+			newImpulse = std::max( newImpulse, 0.f );
+		}
+
+		impulse = newImpulse - row.accumPositionImp;
+		row.accumPositionImp = newImpulse;
+
+		bodyA.applyPositionImpulse( jac.vA, jac.wA, impulse );
+		bodyB.applyPositionImpulse( jac.vB, jac.wB, impulse );
+	}
+}
+
+// Solve soft rows with error tracked through position changes of the substeps so far
+// Relaxing runs without bias to remove velocity added by position correction
+void solveSoftRows( std::vector<SolverRow>& rows,
+					int beginRowIdx,
+					int endRowIdx,
+					const Real invSubstepTime,
+					const bool useBias,
+					std::vector<SolverBody>& updatedBodiesOut )
+{
+	for ( int rowIdx = beginRowIdx; rowIdx < endRowIdx; rowIdx++ )
+	{
+		SolverRow& row = rows[ rowIdx ];
+		SolverBody& bodyA = updatedBodiesOut[ row.bodyIdxA ];
+		SolverBody& bodyB = updatedBodiesOut[ row.bodyIdxB ];
+		const Jacobian& jac = row.jac;
+
+		Real Jv =
+			jac.vA.dot<2>( bodyA.v ) + jac.wA( 2 ) * bodyA.w( 2 ) +
+			jac.vB.dot<2>( bodyB.v ) + jac.wB( 2 ) * bodyB.w( 2 );
+
+		Real bias = 0.f;
+		Real massScale = 1.f;
+		Real impulseScale = 0.f;
+
+		if ( row.type == Constraint::MOTOR )
+		{
+			// Motors drive to their target in relax iterations too
+			bias = row.error;
+		}
+		else
+		{
+			// Moving along the jacobian reduces error
+			const Real error = row.error - (
+				jac.vA.dot<2>( bodyA.dp ) + jac.wA( 2 ) * bodyA.dRot +
+				jac.vB.dot<2>( bodyB.dp ) + jac.wB( 2 ) * bodyB.dRot );
+
+			if ( row.type == Constraint::CONTACT && error < 0.f )
+			{
+				// Separated, allow closing the gap within the substep, relaxing too
+				bias = error * invSubstepTime;
+			}
+			else if ( useBias )
+			{
+				bias = row.biasRate * error;
+				massScale = row.massScale;
+				impulseScale = row.impulseScale;
 			}
+		}
+
+		Real impulse = -( Jv - bias ) * row.invEffMass * massScale - row.accumImp * impulseScale;
+
+		Assert( !isinf( impulse ), "infinite impulse in solver" );
+		Assert( !isnan( impulse ), "nan impulse in solver" );
+
+		impulse = accumulateClampedImpulse( rows, row, impulse );
+
+		bodyA.applyImpulse( jac.vA, jac.wA, impulse );
+		bodyB.applyImpulse( jac.vB, jac.wB, impulse );
+	}
+}
+
+physicsSolver::physicsSolver( physicsThreadPool* threadPool ) :
+	m_threadPool( threadPool )
+{
+	m_simdSolver = new physicsSimdSolver;
+	m_directSolver = new physicsDirectSolver;
+}
+
+physicsSolver::~physicsSolver()
+{
+	delete m_simdSolver;
+	delete m_directSolver;
+}
+
+void physicsSolver::prepareRows(
+	const SolverInfo& info,
+	bool isContact,
+	const std::vector<ConstrainedPair>& constrainedPairs,
+	const std::vector<SolverBody>& solverBodies )
+{
+	for ( int i = 0; i < ( int )constrainedPairs.size(); i++ )
+	{
+		const ConstrainedPair& pair = constrainedPairs[i];
+		prepareConstrainedPair( info, isContact, pair, pair.solverBodyIdxA, pair.solverBodyIdxB, solverBodies, m_rows, m_blocks );
+		m_pairRowOffsets.push_back( ( int )m_rows.size() );
+	}
+}
+
+void physicsSolver::clearRows()
+{
+	m_rows.clear();
+	m_blocks.clear();
+	m_pairRowOffsets.assign( 1, 0 );
+}
 
-			// Impulse applied @ contact point
-//			if ( isContact )
-			if ( false )
+void physicsSolver::storeImpulses( std::vector<ConstrainedPair>& constrainedPairs, int firstPreparedPairIdx ) const
+{
+	for ( int i = 0; i < ( int )constrainedPairs.size(); i++ )
+	{
+		std::vector<Constraint>& constraints = constrainedPairs[i].constraints;
+		const int firstRowIdx = m_pairRowOffsets[firstPreparedPairIdx + i];
+
+		for ( int j = 0; j < ( int )constraints.size(); j++ )
+		{
+			constraints[j].accumImp = m_rows[firstRowIdx + j].accumImp;
+		}
+	}
+}
+
+void physicsSolver::colorConstrainedPairs(
+	const std::vector<ConstrainedPair>& constrainedPairs,
+	const std::vector<SolverBody>& solverBodies )
+{
+	const int numPairs = ( int )constrainedPairs.size();
+
+	m_bodyColorMasks.assign( solverBodies.size(), 0 );
+	m_pairColors.resize( numPairs );
+	m_colorOffsets.assign( g_maxColors + 2, 0 );
+
+	// Greedily take the smallest color not used by either body, static bodies never conflict
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		const ConstrainedPair& pair = constrainedPairs[i];
+		const bool dynamicA = solverBodies[pair.solverBodyIdxA].isDynamic();
+		const bool dynamicB = solverBodies[pair.solverBodyIdxB].isDynamic();
+
+		unsigned long long usedColors = 0;
+		if ( dynamicA ) usedColors |= m_bodyColorMasks[pair.solverBodyIdxA];
+		if ( dynamicB ) usedColors |= m_bodyColorMasks[pair.solverBodyIdxB];
+
+		int color = 0;
+		while ( color < g_maxColors && ( usedColors & ( 1ull << color ) ) )
+		{
+			color++;
+		}
+
+		if ( color < g_maxColors )
+		{
+			if ( dynamicA ) m_bodyColorMasks[pair.solverBodyIdxA] |= ( 1ull << color );
+			if ( dynamicB ) m_bodyColorMasks[pair.solverBodyIdxB] |= ( 1ull << color );
+		}
+
+		m_pairColors[i] = color;
+		m_colorOffsets[color + 1]++;
+	}
+
+	// Counting sort pairs by color
+	for ( int c = 0; c < g_maxColors + 1; c++ )
+	{
+		m_colorOffsets[c + 1] += m_colorOffsets[c];
+	}
+
+	m_coloredPairs.resize( numPairs );
+	m_cursors.assign( m_colorOffsets.begin(), m_colorOffsets.end() - 1 );
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		m_coloredPairs[m_cursors[m_pairColors[i]]++] = i;
+	}
+}
+
+void physicsSolver::solveColoredConstraints(
+	const SolverInfo& info,
+	std::vector<ConstrainedPair>& constrainedPairs,
+	std::vector<SolverBody>& solverBodies )
+{
+	colorConstrainedPairs( constrainedPairs, solverBodies );
+
+	enum Pass
+	{
+		WARM_START,
+		VELOCITY,
+		POSITION
+	};
+
+	Pass pass = WARM_START;
+	int colorBegin = 0;
+	std::atomic<Real> maxResidual( 0.f );
+
+	const auto solveRange = [&]( int begin, int end )
+	{
+		Real rangeResidual = 0.f;
+
+		for ( int i = colorBegin + begin; i < colorBegin + end; i++ )
+		{
+			const int pairIdx = m_coloredPairs[i];
+			const int beginRowIdx = m_pairRowOffsets[pairIdx];
+			const int endRowIdx = m_pairRowOffsets[pairIdx + 1];
+
+			if ( pass == WARM_START )
+			{
+				warmStartRows( m_rows, beginRowIdx, endRowIdx, solverBodies );
+			}
+			else if ( pass == VELOCITY )
+			{
+				Real residual = solveRows( m_rows, m_blocks, beginRowIdx, endRowIdx, solverBodies );
+				rangeResidual = std::max( rangeResidual, residual );
+			}
+			else
+			{
+				solvePositionRows( m_rows, beginRowIdx, endRowIdx, solverBodies );
+			}
+		}
+
+		// Only velocity passes have a residual, each range publishes its largest once
+		if ( pass == VELOCITY )
+		{
+			raiseResidual( maxResidual, rangeResidual );
+		}
+	};
+
+	// Colors run one after another, pairs within a color run in parallel
+	const auto solveColors = [&]()
+	{
+		for ( int color = 0; color < g_maxColors + 1; color++ )
+		{
+			colorBegin = m_colorOffsets[color];
+			int numColorPairs = m_colorOffsets[color + 1] - colorBegin;
+
+			if ( color == g_maxColors )
+			{
+				// Overflow color may have conflicting pairs
+				solveRange( 0, numColorPairs );
+			}
+			else
+			{
+				m_threadPool->parallelFor( numColorPairs, g_minPairsPerTask, solveRange );
+			}
+		}
+	};
+
+	solveColors();
+
+	pass = VELOCITY;
+	for ( int iter = 0; iter < info.m_numIter; iter++ )
+	{
+		maxResidual = 0.f;
+		solveColors();
+
+		if ( iter + 1 >= info.m_minIter && maxResidual <= info.m_velocityTolerance )
+		{
+			break;
+		}
+	}
+
+	pass = POSITION;
+	for ( int iter = 0; iter < info.m_numPositionIter; iter++ )
+	{
+		solveColors();
+	}
+}
+
+void physicsSolver::solveJacobiConstraints(
+	const SolverInfo& info,
+	bool isContact,
+	std::vector<ConstrainedPair>& constrainedPairs,
+	std::vector<SolverBody>& solverBodies )
+{
+	const int numPairs = ( int )constrainedPairs.size();
+	const int numBodies = ( int )solverBodies.size();
+
+	// Each dynamic body is split into one copy per pair touching it
+	m_bodySplitOffsets.assign( numBodies + 1, 0 );
+
+	for ( auto iter = constrainedPairs.begin(); iter != constrainedPairs.end(); iter++ )
+	{
+		if ( solverBodies[iter->solverBodyIdxA].isDynamic() ) m_bodySplitOffsets[iter->solverBodyIdxA + 1]++;
+		if ( solverBodies[iter->solverBodyIdxB].isDynamic() ) m_bodySplitOffsets[iter->solverBodyIdxB + 1]++;
+	}
+
+	for ( int i = 0; i < numBodies; i++ )
+	{
+		m_bodySplitOffsets[i + 1] += m_bodySplitOffsets[i];
+	}
+
+	m_bodySplits.resize( m_bodySplitOffsets[numBodies] );
+	m_splitBodies.resize( 2 * numPairs );
+	m_cursors.assign( m_bodySplitOffsets.begin(), m_bodySplitOffsets.end() - 1 );
+
+	// Copies carry an equal share of mass, so averaging them after each pass keeps momentum
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		const int bodyIdxs[2] = { constrainedPairs[i].solverBodyIdxA, constrainedPairs[i].solverBodyIdxB };
+
+		for ( int j = 0; j < 2; j++ )
+		{
+			const int bodyIdx = bodyIdxs[j];
+			SolverBody& splitBody = m_splitBodies[2 * i + j];
+			splitBody = solverBodies[bodyIdx];
+
+			if ( splitBody.isDynamic() )
+			{
+				const Real numSplits = ( Real )( m_bodySplitOffsets[bodyIdx + 1] - m_bodySplitOffsets[bodyIdx] );
+				splitBody.mInv *= numSplits;
+				splitBody.iInv *= numSplits;
+				m_bodySplits[m_cursors[bodyIdx]++] = 2 * i + j;
+			}
+		}
+	}
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		prepareConstrainedPair( info, isContact, constrainedPairs[i], 2 * i, 2 * i + 1, m_splitBodies, m_rows, m_blocks );
+		m_pairRowOffsets.push_back( ( int )m_rows.size() );
+	}
+
+	enum Pass
+	{
+		WARM_START,
+		VELOCITY,
+		POSITION
+	};
+
+	Pass pass = WARM_START;
+	std::atomic<Real> maxResidual( 0.f );
+
+	// Pairs start from averaged bodies and only write their own copies
+	const auto solvePairs = [&]( int begin, int end )
+	{
+		Real rangeResidual = 0.f;
+
+		for ( int i = begin; i < end; i++ )
+		{
+			const int bodyIdxs[2] = { constrainedPairs[i].solverBodyIdxA, constrainedPairs[i].solverBodyIdxB };
+
+			for ( int j = 0; j < 2; j++ )
+			{
+				const SolverBody& body = solverBodies[bodyIdxs[j]];
+				SolverBody& splitBody = m_splitBodies[2 * i + j];
+				splitBody.v = body.v;
+				splitBody.w = body.w;
+				splitBody.dp = body.dp;
+				splitBody.dRot = body.dRot;
+			}
+
+			const int beginRowIdx = m_pairRowOffsets[i];
+			const int endRowIdx = m_pairRowOffsets[i + 1];
+
+			if ( pass == WARM_START )
+			{
+				warmStartRows( m_rows, beginRowIdx, endRowIdx, m_splitBodies );
+			}
+			else if ( pass == VELOCITY )
+			{
+				Real residual = solveRows( m_rows, m_blocks, beginRowIdx, endRowIdx, m_splitBodies );
+				rangeResidual = std::max( rangeResidual, residual );
+			}
+			else
+			{
+				solvePositionRows( m_rows, beginRowIdx, endRowIdx, m_splitBodies );
+			}
+		}
+
+		if ( pass == VELOCITY )
+		{
+			raiseResidual( maxResidual, rangeResidual );
+		}
+	};
+
+	const auto averageBodies = [&]( int begin, int end )
+	{
+		for ( int bodyIdx = begin; bodyIdx < end; bodyIdx++ )
+		{
+			const int beginSplitIdx = m_bodySplitOffsets[bodyIdx];
+			const int endSplitIdx = m_bodySplitOffsets[bodyIdx + 1];
+
+			if ( beginSplitIdx == endSplitIdx )
+			{
+				continue;
+			}
+
+			SolverBody& body = solverBodies[bodyIdx];
+			const Real invNumSplits = 1.f / ( endSplitIdx - beginSplitIdx );
+
+			if ( pass == POSITION )
+			{
+				body.dp.setZero();
+				body.dRot = 0.f;
+
+				for ( int k = beginSplitIdx; k < endSplitIdx; k++ )
+				{
+					body.dp += m_splitBodies[m_bodySplits[k]].dp;
+					body.dRot += m_splitBodies[m_bodySplits[k]].dRot;
+				}
+
+				body.dp *= invNumSplits;
+				body.dRot *= invNumSplits;
+			}
+			else
 			{
-				drawArrow( bodyA.pos + rA_world, jac.vA * impulse * 0.01f, RED );
-				drawArrow( bodyB.pos + rB_world, jac.vB * impulse * 0.01f, BLUE );
-				drawArrow( bodyA.pos, rA_world, RED );
-				drawArrow( bodyB.pos, rB_world, BLUE );
+				body.v.setZero();
+				body.w.setZero();
+
+				for ( int k = beginSplitIdx; k < endSplitIdx; k++ )
+				{
+					body.v += m_splitBodies[m_bodySplits[k]].v;
+					body.w += m_splitBodies[m_bodySplits[k]].w;
+				}
+
+				body.v *= invNumSplits;
+				body.w *= invNumSplits;
 			}
+		}
+	};
 
-			bodyA.v += jac.vA * impulse * bodyA.mInv;
-			bodyB.v += jac.vB * impulse * bodyB.mInv;
-			bodyA.w += jac.wA * impulse * bodyA.iInv;
-			bodyB.w += jac.wB * impulse * bodyB.iInv;
+	const auto runPass = [&]()
+	{
+		m_threadPool->parallelFor( numPairs, g_minPairsPerTask, solvePairs );
+		m_threadPool->parallelFor( numBodies, g_minBodiesPerTask, averageBodies );
+	};
+
+	runPass();
+
+	pass = VELOCITY;
+	for ( int iter = 0; iter < info.m_numIter; iter++ )
+	{
+		maxResidual = 0.f;
+		runPass();
 
-			// TODO: clean-up these sanity checks
-			Assert( !bodyA.v.isInf(), "bodyA has infinite linear velocity in solver" );
-			Assert( !bodyB.v.isInf(), "bodyB has infinite linear velocity in solver" );
-			Assert( !bodyA.v.isNan(), "bodyA has nan linear velocity in solver" );
-			Assert( !bodyB.v.isNan(), "bodyB has nan linear velocity in solver" );
-			Assert( !bodyA.w.isInf(), "bodyA has infinite angular velocity in solver" );
-			Assert( !bodyB.w.isInf(), "bodyB has infinite angular velocity in solver" );
-			Assert( !bodyA.w.isNan(), "bodyA has nan angular velocity in solver" );
-			Assert( !bodyB.w.isNan(), "bodyB has nan angular velocity in solver" );
+		if ( iter + 1 >= info.m_minIter && maxResidual <= info.m_velocityTolerance )
+		{
+			break;
 		}
 	}
+
+	pass = POSITION;
+	for ( int iter = 0; iter < info.m_numPositionIter; iter++ )
+	{
+		runPass();
+	}
 }
 
 void physicsSolver::solveConstraints(
@@ -122,9 +874,151 @@ void physicsSolver::solveConstraints(
 	std::vector<ConstrainedPair>& constrainedPairs,
 	std::vector<SolverBody>& solverBodies )
 {
-	// Solve constraints, put satisfying velocities in solver bodies
-	for ( int i = 0; i < info.m_numIter; i++ )
+	if ( info.m_solverType == physicsSolverType::SIMD )
+	{
+		m_simdSolver->solveConstraints( info, isContact, constrainedPairs, solverBodies );
+
+		// Batches have no position pass, run it over scalar rows
+		if ( info.m_numPositionIter > 0 )
+		{
+			clearRows();
+			prepareRows( info, isContact, constrainedPairs, solverBodies );
+
+			for ( int i = 0; i < info.m_numPositionIter; i++ )
+			{
+				solvePositionRows( m_rows, 0, ( int )m_rows.size(), solverBodies );
+			}
+		}
+
+		return;
+	}
+
+	clearRows();
+
+	if ( info.m_solverType == physicsSolverType::JACOBI && m_threadPool )
+	{
+		// Rows are prepared against split copies of bodies
+		solveJacobiConstraints( info, isContact, constrainedPairs, solverBodies );
+		storeImpulses( constrainedPairs, 0 );
+		return;
+	}
+
+	prepareRows( info, isContact, constrainedPairs, solverBodies );
+
+	if ( info.m_solverType == physicsSolverType::PARALLEL && m_threadPool )
+	{
+		solveColoredConstraints( info, constrainedPairs, solverBodies );
+	}
+	else
+	{
+		warmStartRows( m_rows, 0, ( int )m_rows.size(), solverBodies );
+
+		// Solve constraints, put satisfying velocities in solver bodies
+		for ( int i = 0; i < info.m_numIter; i++ )
+		{
+			Real maxResidual = solveRows( m_rows, m_blocks, 0, ( int )m_rows.size(), solverBodies );
+
+			if ( i + 1 >= info.m_minIter && maxResidual <= info.m_velocityTolerance )
+			{
+				break;
+			}
+		}
+
+		for ( int i = 0; i < info.m_numPositionIter; i++ )
+		{
+			solvePositionRows( m_rows, 0, ( int )m_rows.size(), solverBodies );
+		}
+	}
+
+	storeImpulses( constrainedPairs, 0 );
+}
+
+void physicsSolver::solveJointsDirect(
+	const SolverInfo& info,
+	std::vector<ConstrainedPair>& jointPairs,
+	std::vector<SolverBody>& solverBodies )
+{
+	// Limits and motors need iterating to find which bounds are active
+	for ( auto iterPair = jointPairs.begin(); iterPair != jointPairs.end(); iterPair++ )
+	{
+		for ( auto iter = iterPair->constraints.begin(); iter != iterPair->constraints.end(); iter++ )
+		{
+			if ( iter->type != Constraint::BILATERAL )
+			{
+				solveConstraints( info, false, jointPairs, solverBodies );
+				return;
+			}
+		}
+	}
+
+	clearRows();
+	prepareRows( info, false, jointPairs, solverBodies );
+
+	const int numDependentRows = m_directSolver->solve( info, jointPairs, m_pairRowOffsets, m_rows, solverBodies );
+
+	// Dropped rows may still be needed, iterating from the direct solution settles them
+	if ( numDependentRows > 0 )
 	{
-		solveConstrainedPairs( info, isContact, constrainedPairs, solverBodies );
+		for ( int i = 0; i < info.m_numIter; i++ )
+		{
+			Real maxResidual = solveRows( m_rows, m_blocks, 0, ( int )m_rows.size(), solverBodies );
+
+			if ( i + 1 >= info.m_minIter && maxResidual <= info.m_velocityTolerance )
+			{
+				break;
+			}
+		}
+
+		for ( int i = 0; i < info.m_numPositionIter; i++ )
+		{
+			solvePositionRows( m_rows, 0, ( int )m_rows.size(), solverBodies );
+		}
 	}
+
+	storeImpulses( jointPairs, 0 );
+}
+
+void physicsSolver::solveSubsteps(
+	const SolverInfo& info,
+	std::vector<ConstrainedPair>& contactPairs,
+	std::vector<ConstrainedPair>& jointPairs,
+	std::vector<SolverBody>& solverBodies )
+{
+	clearRows();
+	prepareRows( info, true, contactPairs, solverBodies );
+	prepareRows( info, false, jointPairs, solverBodies );
+
+	const int numRows = ( int )m_rows.size();
+	const Real h = info.m_deltaTime / info.m_numSubsteps;
+	const Real invH = 1.f / h;
+
+	for ( int substep = 0; substep < info.m_numSubsteps; substep++ )
+	{
+		for ( auto iter = solverBodies.begin(); iter != solverBodies.end(); iter++ )
+		{
+			if ( iter->mInv > 0.f )
+			{
+				iter->v += info.m_gravity * h;
+			}
+		}
+
+		// Accumulated impulses are per substep
+		warmStartRows( m_rows, 0, numRows, solverBodies );
+
+		solveSoftRows( m_rows, 0, numRows, invH, true, solverBodies );
+
+		for ( auto iter = solverBodies.begin(); iter != solverBodies.end(); iter++ )
+		{
+			if ( iter->isDynamic() )
+			{
+				iter->dp += iter->v * h;
+				iter->dRot += iter->w( 2 ) * h;
+			}
+		}
+
+		solveSoftRows( m_rows, 0, numRows, invH, false, solverBodies );
+	}
+
+	storeImpulses( contactPairs, 0 );
+	storeImpulses( jointPairs, ( int )contactPairs.size() );
 }
\ No newline at end of file
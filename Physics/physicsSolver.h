@@ -10,56 +10,259 @@ struct Jacobian
 
 struct Constraint
 {
+	enum Type
+	{
+		BILATERAL = 0, // Unbounded, i.e. joints
+		CONTACT,       // Accumulated impulse can only push
+		FRICTION,      // Accumulated impulse bounded by friction * contact impulse
+		MOTOR          // Drives velocity along row to error, accumulated impulse bounded by +-friction
+	};
+
 	Vector4 rA, rB; // Constrained points viewed from local
-	Real error;
+	Real error;    // MOTOR: target velocity along row
+	Real accumImp; // Impulse accumulated over iterations and steps, applied for warm starting
+	Type type;
+	Real friction; // FRICTION: combined friction coefficient, MOTOR: largest impulse per step
+	int normalIdx; // FRICTION only, index of bounding contact row in pair
 	Jacobian jac;
+
+	Constraint() : error( 0.f ), accumImp( 0.f ), type( BILATERAL ), friction( 0.f ), normalIdx( -1 ) {}
 };
 
 struct ConstrainedPair : public BodyIdPair
 {
 	std::vector<Constraint> constraints;
-	Real accumImp;
+
+	// Dense indices into solver bodies, assigned by the world each step
+	int solverBodyIdxA;
+	int solverBodyIdxB;
 
 	ConstrainedPair( const BodyId a = invalidId, const BodyId b = invalidId ) : 
-		BodyIdPair( a, b ), accumImp(0.f) 
+		BodyIdPair( a, b ),
+		solverBodyIdxA( 0 ),
+		solverBodyIdxB( 0 )
 	{
 
 	}
 
 	ConstrainedPair( const BodyIdPair& other ) : 
-		BodyIdPair( other ), accumImp(0.f)
+		BodyIdPair( other ),
+		solverBodyIdxA( 0 ),
+		solverBodyIdxB( 0 )
 	{
 
 	}
 };
 
+enum class physicsSolverType
+{
+	SEQUENTIAL = 0, // Scalar Gauss-Seidel, one constraint row at a time
+	SIMD,           // Gauss-Seidel over 4-wide batches of rows without shared bodies
+	PARALLEL,       // Scalar Gauss-Seidel over graph colors, each color spread across threads
+	JACOBI          // Jacobi with mass splitting, every pair solved at once across threads and bodies averaged after
+};
+
 struct SolverInfo
 {
 	Real m_deltaTime;
 	int m_numIter;
+	Real m_contactBias; // Fraction of contact penetration corrected per step
+	Real m_jointBias;   // Fraction of joint separation corrected per step
+	physicsSolverType m_solverType;
+
+	// Iterations stop early after m_minIter once no row changes velocity by more than m_velocityTolerance,
+	// m_numIter is the most iterations run. Zero tolerance always runs m_numIter
+	int m_minIter;
+	Real m_velocityTolerance;
+
+	// Split impulse, used when m_numPositionIter > 0 and not substepping
+	// Position error is left out of velocity rows and corrected by this many iterations on position deltas
+	// after velocities are solved, so correction adds no velocity to resting bodies
+	int m_numPositionIter;
+
+	// Joint islands without contacts are solved by one sparse factorization instead of iterating,
+	// islands with joint limits or motors keep iterating. Used when solving island by island without substeps
+	bool m_useDirectJointSolver;
+
+	// Soft step, used when m_numSubsteps > 1
+	int m_numSubsteps;
+	Vector4 m_gravity;           // Applied by the solver each substep
+	Real m_contactHertz;         // Stiffness of contacts and joints as spring frequency
+	Real m_contactDampingRatio;
+	Real m_jointHertz;
+	Real m_jointDampingRatio;
 };
 
 struct SolverBody
 {
+	// Index of the body shared by every static and sleeping body, never moved by the solver
+	static const int STATIC_BODY_IDX = 0;
+
 	Vector4 v;
 	Vector4 w;
-	Vector4 pos; // TODO: remove this
-	Real ori; // TODO: remove this
+	Vector4 dp;  // Position change over substeps, or position correction of split impulse
+	Real dRot;   // Rotation change over substeps, or rotation correction of split impulse
 	Real mInv;
 	Real iInv;
 
-	void setFromBody( const physicsBody& body );
+	void setStatic();
+
+	// Static bodies are never written to by the solver
+	inline bool isDynamic() const { return ( mInv > 0.f || iInv > 0.f ); }
+
+	// Static bodies are left untouched, so pairs solved on other threads may read them
+	inline void applyImpulse( const Vector4& vDir, const Vector4& wDir, const Real impulse )
+	{
+		if ( isDynamic() )
+		{
+			v += vDir * impulse * mInv;
+			w += wDir * impulse * iInv;
+		}
+	}
+
+	// Impulse in position units, moving position deltas instead of velocities
+	inline void applyPositionImpulse( const Vector4& vDir, const Vector4& wDir, const Real impulse )
+	{
+		if ( isDynamic() )
+		{
+			dp += vDir * impulse * mInv;
+			dRot += wDir( 2 ) * impulse * iInv;
+		}
+	}
 };
 
+// Constraint row with constants which don't change over iterations baked in
+// Angular jacobian already holds the world space arms, so iterations only need dot products and clamps
+// Rigid rows use massScale of one and impulseScale of zero
+struct SolverRow
+{
+	Jacobian jac;
+	Real invEffMass;   // 1 / (J M^-1 J^T)
+	Real JmJ;          // J M^-1 J^T, velocity change along row per unit impulse
+	Real error;        // Position error at start of step, target velocity of MOTOR rows
+	Real biasRate;     // Velocity correcting unit position error
+	Real massScale;    // Softening of effective mass
+	Real impulseScale; // Softening of accumulated impulse
+	Real positionBias; // Fraction of error corrected by position iterations, zero without split impulse
+	Real accumImp;
+	Real accumPositionImp;
+	Real friction;
+	Constraint::Type type;
+	int bodyIdxA;
+	int bodyIdxB;
+	int normalRowIdx; // FRICTION only, index of bounding contact row
+	int blockIdx;     // CONTACT only, index of block solving this row together with another, -1 when solved alone
+};
+
+// Both contact rows of a two point manifold, solved together as a 2x2 LCP
+// Only built for rigid steps when K is well conditioned, otherwise rows are solved one by one
+struct SolverBlock
+{
+	Matrix22 K;    // J M^-1 J^T of both rows
+	Matrix22 invK;
+	int rowIdx0;
+	int rowIdx1;
+};
+
+class physicsSimdSolver;
+class physicsDirectSolver;
+class physicsThreadPool;
+
 class physicsSolver
 {
 public:
+
+	// Thread pool is used by PARALLEL and JACOBI solver types and isn't owned by the solver
+	physicsSolver( physicsThreadPool* threadPool );
+
+	~physicsSolver();
+
 	// Accept array of constrained pairs and solver bodies,
     // store constraint-solved velocities in solver bodies
+	// Pairs index solver bodies by solverBodyIdxA/B, solver body STATIC_BODY_IDX must be static
 	void solveConstraints( 
 		const SolverInfo& info,
 		bool isContact,
 		std::vector<ConstrainedPair>& constrainedPairs,
 		std::vector<SolverBody>& solverBodies 
 	);
+
+	// Solve joint rows directly, for islands without contacts
+	// Falls back to solveConstraints when rows bound their impulse, iterates on from the direct solution
+	// when rows had to be dropped as redundant
+	void solveJointsDirect(
+		const SolverInfo& info,
+		std::vector<ConstrainedPair>& jointPairs,
+		std::vector<SolverBody>& solverBodies
+	);
+
+	// Split step into info.m_numSubsteps substeps of soft constraints, each warm starting,
+	// solving once with bias, integrating positions into solver body deltas and relaxing once
+	void solveSubsteps(
+		const SolverInfo& info,
+		std::vector<ConstrainedPair>& contactPairs,
+		std::vector<ConstrainedPair>& jointPairs,
+		std::vector<SolverBody>& solverBodies
+	);
+
+private:
+
+	// Append rows and blocks of all pairs, rows of nth prepared pair span [m_pairRowOffsets[n], m_pairRowOffsets[n + 1])
+	void prepareRows(
+		const SolverInfo& info,
+		bool isContact,
+		const std::vector<ConstrainedPair>& constrainedPairs,
+		const std::vector<SolverBody>& solverBodies
+	);
+
+	void clearRows();
+
+	// Copy accumulated impulses of rows back to constraints for warm starting next step
+	void storeImpulses( std::vector<ConstrainedPair>& constrainedPairs, int firstPreparedPairIdx ) const;
+
+	// Sort pairs by color, pairs of same color share no dynamic body
+	void colorConstrainedPairs(
+		const std::vector<ConstrainedPair>& constrainedPairs,
+		const std::vector<SolverBody>& solverBodies
+	);
+
+	// Solve rows already prepared by prepareRows, color by color
+	void solveColoredConstraints(
+		const SolverInfo& info,
+		std::vector<ConstrainedPair>& constrainedPairs,
+		std::vector<SolverBody>& solverBodies
+	);
+
+	// Each pair solves against its own copy of its bodies, with mass divided among the pairs sharing the body,
+	// then copies are averaged back into bodies. No pair waits on another, so there is no coloring
+	void solveJacobiConstraints(
+		const SolverInfo& info,
+		bool isContact,
+		std::vector<ConstrainedPair>& constrainedPairs,
+		std::vector<SolverBody>& solverBodies
+	);
+
+	physicsSimdSolver* m_simdSolver;
+	physicsDirectSolver* m_directSolver;
+	physicsThreadPool* m_threadPool;
+
+	std::vector<SolverRow> m_rows;
+	std::vector<int> m_pairRowOffsets;
+	std::vector<SolverBlock> m_blocks;
+
+	// Pair indices sorted by color, color c spans [m_colorOffsets[c], m_colorOffsets[c + 1])
+	std::vector<int> m_coloredPairs;
+	std::vector<int> m_colorOffsets;
+	std::vector<int> m_pairColors;
+	std::vector<unsigned long long> m_bodyColorMasks;
+
+	// Copies of bodies A and B of nth pair at 2n and 2n + 1, used by JACOBI
+	std::vector<SolverBody> m_splitBodies;
+
+	// Copies of solver body b span [m_bodySplitOffsets[b], m_bodySplitOffsets[b + 1]) in m_bodySplits
+	std::vector<int> m_bodySplitOffsets;
+	std::vector<int> m_bodySplits;
+
+	// Next free position of each bucket while counting sorting into m_coloredPairs or m_bodySplits
+	std::vector<int> m_cursors;
 };
@@ -0,0 +1,262 @@
+#include <algorithm>
+
+#include <physicsThreadPool.h>
+
+static inline unsigned long long packRange( int begin, int end )
+{
+	return ( unsigned long long )( unsigned int )begin | ( ( unsigned long long )( unsigned int )end << 32 );
+}
+
+static inline void unpackRange( unsigned long long range, int& begin, int& end )
+{
+	begin = ( int )( unsigned int )( range & 0xffffffffull );
+	end = ( int )( unsigned int )( range >> 32 );
+}
+
+physicsThreadPool::physicsThreadPool( int numThreads ) :
+	m_func( nullptr ),
+	m_taskFunc( nullptr ),
+	m_workRanges( nullptr ),
+	m_nextItem( 0 ),
+	m_count( 0 ),
+	m_chunkSize( 1 ),
+	m_numBusyWorkers( 0 ),
+	m_generation( 0 ),
+	m_quit( false )
+{
+	if ( numThreads <= 0 )
+	{
+		numThreads = std::max( 1, ( int )std::thread::hardware_concurrency() );
+	}
+
+	m_workRanges = new WorkRange[numThreads];
+
+	for ( int i = 0; i < numThreads; i++ )
+	{
+		m_workRanges[i].range = 0;
+	}
+
+	// Calling thread is the first thread
+	for ( int i = 1; i < numThreads; i++ )
+	{
+		m_workers.push_back( std::thread( &physicsThreadPool::workerMain, this, i ) );
+	}
+}
+
+physicsThreadPool::~physicsThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_quit = true;
+	}
+
+	m_wakeCondition.notify_all();
+
+	for ( auto iter = m_workers.begin(); iter != m_workers.end(); iter++ )
+	{
+		iter->join();
+	}
+
+	delete[] m_workRanges;
+}
+
+void physicsThreadPool::parallelFor( int count, int minChunk, const RangeFunc& func )
+{
+	if ( count <= 0 )
+	{
+		return;
+	}
+
+	minChunk = std::max( minChunk, 1 );
+
+	if ( m_workers.empty() || count <= minChunk )
+	{
+		func( 0, count );
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_func = &func;
+		m_count = count;
+		m_chunkSize = std::max( minChunk, count / ( 4 * getNumThreads() ) );
+		m_nextItem = 0;
+	}
+
+	runJob();
+}
+
+void physicsThreadPool::runTasks( int count, const TaskFunc& func )
+{
+	if ( count <= 0 )
+	{
+		return;
+	}
+
+	if ( m_workers.empty() || count == 1 )
+	{
+		for ( int i = 0; i < count; i++ )
+		{
+			func( i, 0 );
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_taskFunc = &func;
+
+		// Contiguous slices, stealing evens out uneven item costs
+		const int numThreads = getNumThreads();
+		for ( int i = 0; i < numThreads; i++ )
+		{
+			m_workRanges[i].range = packRange( ( int )( ( long long )count * i / numThreads ),
+											   ( int )( ( long long )count * ( i + 1 ) / numThreads ) );
+		}
+	}
+
+	runJob();
+}
+
+void physicsThreadPool::runJob()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_numBusyWorkers = ( int )m_workers.size();
+		m_generation++;
+	}
+
+	m_wakeCondition.notify_all();
+
+	work( 0 );
+
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_doneCondition.wait( lock, [this]() { return m_numBusyWorkers == 0; } );
+	m_func = nullptr;
+	m_taskFunc = nullptr;
+}
+
+void physicsThreadPool::work( int threadIdx )
+{
+	if ( m_taskFunc )
+	{
+		runStolenTasks( threadIdx );
+	}
+	else
+	{
+		runChunks();
+	}
+}
+
+void physicsThreadPool::runChunks()
+{
+	while ( true )
+	{
+		int begin = m_nextItem.fetch_add( m_chunkSize );
+
+		if ( begin >= m_count )
+		{
+			break;
+		}
+
+		( *m_func )( begin, std::min( begin + m_chunkSize, m_count ) );
+	}
+}
+
+void physicsThreadPool::runStolenTasks( int threadIdx )
+{
+	int item;
+
+	while ( popTask( threadIdx, item ) || stealTask( threadIdx, item ) )
+	{
+		( *m_taskFunc )( item, threadIdx );
+	}
+}
+
+bool physicsThreadPool::popTask( int threadIdx, int& itemOut )
+{
+	std::atomic<unsigned long long>& range = m_workRanges[threadIdx].range;
+	unsigned long long current = range.load();
+
+	while ( true )
+	{
+		int begin, end;
+		unpackRange( current, begin, end );
+
+		if ( begin >= end )
+		{
+			return false;
+		}
+
+		if ( range.compare_exchange_weak( current, packRange( begin + 1, end ) ) )
+		{
+			itemOut = begin;
+			return true;
+		}
+	}
+}
+
+bool physicsThreadPool::stealTask( int threadIdx, int& itemOut )
+{
+	const int numThreads = getNumThreads();
+
+	for ( int i = 1; i < numThreads; i++ )
+	{
+		const int victimIdx = ( threadIdx + i ) % numThreads;
+		std::atomic<unsigned long long>& range = m_workRanges[victimIdx].range;
+		unsigned long long current = range.load();
+
+		while ( true )
+		{
+			int begin, end;
+			unpackRange( current, begin, end );
+
+			if ( begin >= end )
+			{
+				break;
+			}
+
+			// Take upper half, victim keeps popping from the front
+			const int stealBegin = end - ( end - begin + 1 ) / 2;
+
+			if ( range.compare_exchange_weak( current, packRange( begin, stealBegin ) ) )
+			{
+				// Own slice is empty here so no other thread writes it
+				m_workRanges[threadIdx].range = packRange( stealBegin + 1, end );
+				itemOut = stealBegin;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void physicsThreadPool::workerMain( int threadIdx )
+{
+	unsigned int seenGeneration = 0;
+
+	while ( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_wakeCondition.wait( lock, [&]() { return m_quit || m_generation != seenGeneration; } );
+
+			if ( m_quit )
+			{
+				return;
+			}
+
+			seenGeneration = m_generation;
+		}
+
+		work( threadIdx );
+
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_numBusyWorkers--;
+		}
+
+		m_doneCondition.notify_one();
+	}
+}
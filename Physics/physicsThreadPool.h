@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Non-owning reference to a callable, which has to outlive the reference
+// Calls go through a function pointer, so unlike std::function nothing is copied or allocated
+template <typename Signature>
+class physicsFuncRef;
+
+template <typename R, typename... Args>
+class physicsFuncRef<R( Args... )>
+{
+public:
+
+	template <typename Func>
+	physicsFuncRef( const Func& func ) :
+		m_callable( &func ),
+		m_call( &callFunc<Func> )
+	{
+
+	}
+
+	R operator()( Args... args ) const { return m_call( m_callable, args... ); }
+
+private:
+
+	template <typename Func>
+	static R callFunc( const void* callable, Args... args ) { return ( *static_cast< const Func* >( callable ) )( args... ); }
+
+	const void* m_callable;
+	R ( *m_call )( const void* callable, Args... args );
+};
+
+// Fixed set of worker threads used by the world to run work in parallel
+// The calling thread takes part in the work, so a pool of one thread runs everything inline
+class physicsThreadPool
+{
+public:
+
+	// Range [begin, end) of work items
+	// Referenced only for the duration of the call, so pass a named lambda rather than storing a RangeFunc
+	typedef physicsFuncRef<void( int begin, int end )> RangeFunc;
+
+	// Single work item along with index of thread running it, in [0, getNumThreads())
+	typedef physicsFuncRef<void( int item, int threadIdx )> TaskFunc;
+
+	// Zero threads uses number of hardware threads
+	physicsThreadPool( int numThreads );
+
+	~physicsThreadPool();
+
+	int getNumThreads() const { return ( int )m_workers.size() + 1; }
+
+	// Split [0, count) into chunks of at least minChunk items and run func over them on all threads
+	// Returns once every chunk is done, so consecutive calls are separated by a barrier
+	void parallelFor( int count, int minChunk, const RangeFunc& func );
+
+	// Run func once for each item in [0, count), for items of uneven cost
+	// Every thread starts with a slice of the items and steals half of another thread's slice once its own runs out
+	// Returns once every item is done
+	void runTasks( int count, const TaskFunc& func );
+
+private:
+
+	// Items [begin, end) left to a thread packed as begin | end << 32, so owner and thieves race on one word
+	// Padded to keep threads off each other's cache line
+	struct WorkRange
+	{
+		std::atomic<unsigned long long> range;
+		char pad[64 - sizeof( std::atomic<unsigned long long> )];
+	};
+
+	void workerMain( int threadIdx );
+
+	// Dispatch current job to all workers and take part from calling thread
+	void runJob();
+
+	// Run whichever job is current
+	void work( int threadIdx );
+
+	// Grab chunks until none are left
+	void runChunks();
+
+	// Run own items, then steal from other threads until all are empty
+	void runStolenTasks( int threadIdx );
+
+	// Pop next item from own slice
+	bool popTask( int threadIdx, int& itemOut );
+
+	// Move half of another thread's remaining items to own slice and pop one
+	bool stealTask( int threadIdx, int& itemOut );
+
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+
+	const RangeFunc* m_func;
+	const TaskFunc* m_taskFunc;
+	WorkRange* m_workRanges;
+	std::atomic<int> m_nextItem;
+	int m_count;
+	int m_chunkSize;
+	int m_numBusyWorkers;
+	unsigned int m_generation;
+	bool m_quit;
+};
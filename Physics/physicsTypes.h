@@ -2,6 +2,17 @@
 
 #include <Base.h>
 
-typedef unsigned short BodyId;
-typedef unsigned short JointId;
+typedef unsigned int BodyId; // Slot index and generation, see physicsBodyStorage
+typedef unsigned int JointId; // Slot index and generation, see physicsJointPool
+typedef unsigned int ShapeId; // Pool index and shape type, see physicsShapeRegistry
+typedef unsigned short FeatureId;
 const BodyId invalidId = -1;
+const JointId invalidJointId = -1;
+const ShapeId invalidShapeId = -1;
+
+// Body handle is slot index in low bits and slot generation in high bits
+// Arrays kept per body are indexed by slot index
+const int g_bodyIdxBits = 20;
+const BodyId g_bodyIdxMask = ( 1u << g_bodyIdxBits ) - 1;
+
+inline int getBodyIdx( BodyId bodyId ) { return ( int )( bodyId & g_bodyIdxMask ); }
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <physicsKernels.h>
+#include <physicsSolver.h>
+
+// Kernels written once over wide types, instantiated by the translation unit of each instruction set
+// Kept in an unnamed namespace so every translation unit has its own copy and the linker can't swap
+// in one compiled for another instruction set
+// Products and sums are kept separate instead of fused, so every level finds the same overlaps and
+// supporting vertices as the scalar kernels
+namespace
+{
+	template <typename RealW>
+	int findOverlapsWide( const SweepAabbs& aabbs, int aabbIdx, int* overlapsOut )
+	{
+		const int W = RealW::WIDTH;
+		const int allLanes = ( 1 << W ) - 1;
+
+		const Real minAx = aabbs.minX[aabbIdx], minAy = aabbs.minY[aabbIdx];
+		const Real maxAx = aabbs.maxX[aabbIdx], maxAy = aabbs.maxY[aabbIdx];
+		const Real centerAx = ( maxAx + minAx ) * 0.5f;
+		const Real centerAy = ( maxAy + minAy ) * 0.5f;
+
+		const RealW maxAxW( maxAx ), maxAyW( maxAy );
+		const RealW centerAxW( centerAx ), centerAyW( centerAy );
+		const RealW halfExtentAxW( maxAx - centerAx ), halfExtentAyW( maxAy - centerAy );
+		const RealW half( 0.5f );
+
+		int numOverlaps = 0;
+
+		for ( int i = aabbIdx + 1; i < aabbs.numAabbs; i += W )
+		{
+			const RealW minBx = RealW::load( &aabbs.minX[i] );
+			const RealW minBy = RealW::load( &aabbs.minY[i] );
+			const RealW maxBx = RealW::load( &aabbs.maxX[i] );
+			const RealW maxBy = RealW::load( &aabbs.maxY[i] );
+
+			// Aabbs starting past max x of aabbIdx end the sweep, padding past the last aabb never overlaps
+			const auto inRange = ( minBx <= maxAxW );
+
+			const RealW centerBx = ( maxBx + minBx ) * half;
+			const RealW centerBy = ( maxBy + minBy ) * half;
+
+			RealW dx; dx.setAbs( centerAxW - centerBx );
+			RealW dy; dy.setAbs( centerAyW - centerBy );
+			const RealW sumX = halfExtentAxW + maxBx - centerBx;
+			const RealW sumY = halfExtentAyW + maxBy - centerBy;
+
+			const int overlapMask = ( inRange & ( dx < sumX ) & ( dy < sumY ) ).getMask();
+
+			for ( int lane = 0; overlapMask != 0 && lane < W; lane++ )
+			{
+				if ( overlapMask & ( 1 << lane ) )
+				{
+					overlapsOut[numOverlaps++] = i + lane;
+				}
+			}
+
+			if ( inRange.getMask() != allLanes )
+			{
+				break;
+			}
+		}
+
+		return numOverlaps;
+	}
+
+	template <typename Vec2W, typename RealW>
+	int findSupportingVertexWide( const Real* xs, const Real* ys, int numVertices, Real dirX, Real dirY )
+	{
+		const int W = RealW::WIDTH;
+
+		Real lanes[W];
+		for ( int lane = 0; lane < W; lane++ )
+		{
+			lanes[lane] = ( Real )lane;
+		}
+
+		const RealW dirXW( dirX ), dirYW( dirY );
+		const RealW laneStep( ( Real )W );
+
+		// Each lane keeps its first largest dot and that vertex's index, exact as float below 2^24 vertices
+		RealW dotMax( std::numeric_limits<Real>::lowest() );
+		RealW idxMax( 0.f );
+		RealW idx = RealW::load( lanes );
+
+		for ( int i = 0; i < numVertices; i += W )
+		{
+			const Vec2W vertices = Vec2W::load( &xs[i], &ys[i] );
+			const RealW dot = dirXW * vertices.m_x + dirYW * vertices.m_y;
+
+			const auto isLarger = ( dot > dotMax );
+			dotMax.setSelect( isLarger, dot, dotMax );
+			idxMax.setSelect( isLarger, idx, idxMax );
+
+			idx = idx + laneStep;
+		}
+
+		// Largest of lanes, lowest index among equal dots like the scalar scan
+		Real dots[W], indices[W];
+		dotMax.store( dots );
+		idxMax.store( indices );
+
+		int best = 0;
+		for ( int lane = 1; lane < W; lane++ )
+		{
+			if ( dots[lane] > dots[best] || ( dots[lane] == dots[best] && indices[lane] < indices[best] ) )
+			{
+				best = lane;
+			}
+		}
+
+		return ( int )indices[best];
+	}
+
+	template <typename RealW>
+	Real solveRowBatchesWide( const SimdRowBatches& rows, Real* accumImp, SolverBody* solverBodies )
+	{
+		const int W = RealW::WIDTH;
+		Assert( rows.width == W, "rows batched for other width" );
+
+		// Solved velocities of bodies, gathered and scattered lane by lane
+		const int stride = sizeof( SolverBody ) / sizeof( Real );
+		Real* vx = reinterpret_cast< Real* >( &solverBodies->v );
+		Real* vy = vx + 1;
+		Real* wz = reinterpret_cast< Real* >( &solverBodies->w ) + 2;
+
+		const RealW zero( 0.f );
+		RealW residual( 0.f );
+
+		for ( int row = 0; row < rows.numBatches * W; row += W )
+		{
+			const int* idxA = &rows.bodyIdxA[row];
+			const int* idxB = &rows.bodyIdxB[row];
+
+			RealW vAx = RealW::gather( vx, idxA, stride );
+			RealW vAy = RealW::gather( vy, idxA, stride );
+			RealW wAz = RealW::gather( wz, idxA, stride );
+			RealW vBx = RealW::gather( vx, idxB, stride );
+			RealW vBy = RealW::gather( vy, idxB, stride );
+			RealW wBz = RealW::gather( wz, idxB, stride );
+
+			const RealW Jv =
+				( RealW::load( &rows.jvAx[row] ) * vAx + RealW::load( &rows.jvAy[row] ) * vAy + RealW::load( &rows.jwA[row] ) * wAz ) +
+				( RealW::load( &rows.jvBx[row] ) * vBx + RealW::load( &rows.jvBy[row] ) * vBy + RealW::load( &rows.jwB[row] ) * wBz );
+
+			RealW impulse = ( RealW::load( &rows.biasVel[row] ) - Jv ) * RealW::load( &rows.invEffMass[row] );
+
+			// Friction rows are bounded by impulse of their contact row, solved in an earlier batch
+			const RealW normalImp = RealW::gather( accumImp, &rows.normalRowIdx[row], 1 );
+			const RealW limit = RealW::load( &rows.friction[row] ) * normalImp;
+			const auto isFriction = ( RealW::load( &rows.isFriction[row] ) > zero );
+
+			RealW lower; lower.setSelect( isFriction, zero - limit, RealW::load( &rows.lower[row] ) );
+			RealW upper; upper.setSelect( isFriction, limit, RealW::load( &rows.upper[row] ) );
+
+			// Clamp accumulated impulse, apply only the difference
+			const RealW oldImp = RealW::load( &accumImp[row] );
+			RealW newImp; newImp.setMax( oldImp + impulse, lower ); newImp.setMin( newImp, upper );
+			impulse = newImp - oldImp;
+			newImp.store( &accumImp[row] );
+
+			vAx = vAx + RealW::load( &rows.mjvAx[row] ) * impulse;
+			vAy = vAy + RealW::load( &rows.mjvAy[row] ) * impulse;
+			wAz = wAz + RealW::load( &rows.mjwA[row] ) * impulse;
+			vBx = vBx + RealW::load( &rows.mjvBx[row] ) * impulse;
+			vBy = vBy + RealW::load( &rows.mjvBy[row] ) * impulse;
+			wBz = wBz + RealW::load( &rows.mjwB[row] ) * impulse;
+
+			// Lanes never share a dynamic body so no update is lost, static bodies get back what they had
+			wBz.scatter( wz, idxB, stride );
+			vBy.scatter( vy, idxB, stride );
+			vBx.scatter( vx, idxB, stride );
+			wAz.scatter( wz, idxA, stride );
+			vAy.scatter( vy, idxA, stride );
+			vAx.scatter( vx, idxA, stride );
+
+			RealW absImpulse; absImpulse.setAbs( impulse );
+			residual.setMax( residual, absImpulse * RealW::load( &rows.JmJ[row] ) );
+		}
+
+		Real residuals[W];
+		residual.store( residuals );
+
+		Real maxResidual = 0.f;
+		for ( int lane = 0; lane < W; lane++ )
+		{
+			maxResidual = ( residuals[lane] > maxResidual ) ? residuals[lane] : maxResidual;
+		}
+
+		return maxResidual;
+	}
+}
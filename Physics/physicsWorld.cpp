@@ -1,4 +1,5 @@
 #include <vector>
+#include <algorithm>
 
 #include <Base.h>
 #include <physicsObject.h>
@@ -6,10 +7,22 @@
 #include <physicsBody.h>
 #include <physicsCollider.h>
 #include <physicsSolver.h>
+#include <physicsJoint.h>
 #include <physicsWorld.h>
+#include <physicsThreadPool.h>
+#include <physicsKernels.h>
 
 #include <DebugUtils.h>
 
+// Pair going through narrowphase this step
+struct NarrowphasePair
+{
+	BodyIdPair pair;
+	int cachedPairIdx; // Into m_cachedPairs, -1 if pair has no cache yet
+	int firstContact;  // Into contacts collided this step
+	int numContacts;
+};
+
 // TODO: separate physics as library from the framework
 class physicsWorldEx : public physicsWorld
 {
@@ -21,25 +34,31 @@ public:
 		m_dispatchTable[typeB][typeA] = func;
 	}
 
-	ColliderFuncPtr getCollisionFunc( const physicsBody& bodyA, const physicsBody& bodyB )
+	// Register convex collider specialized for each order of the shape types
+	template <typename ShapeTypeA, typename ShapeTypeB>
+	void registerConvexColliderFunc( physicsShape::Type typeA, physicsShape::Type typeB )
 	{
-		physicsShape::Type typeA = bodyA.getShapeType();
-		physicsShape::Type typeB = bodyB.getShapeType();
-		return m_dispatchTable[typeA][typeB];;
+		m_dispatchTable[typeA][typeB] = physicsConvexCollider::collide<ShapeTypeA, ShapeTypeB>;
+		m_dispatchTable[typeB][typeA] = physicsConvexCollider::collide<ShapeTypeB, ShapeTypeA>;
+	}
+
+	// Index of pair's shape types into flattened dispatch table
+	int getShapePairBucket( const BodyIdPair& pair ) const
+	{
+		physicsShape::Type typeA = m_bodies.getShapeType( pair.bodyIdA );
+		physicsShape::Type typeB = m_bodies.getShapeType( pair.bodyIdB );
+		return typeA * physicsShape::NUM_SHAPES + typeB;
 	}
 
 	void collide();
 
 	// Accept array of indexed AABB's, return pairs which overlap
 	void collideAabbs( const std::vector<BroadphaseBody>& broadphaseBodies,
-		std::vector<BodyIdPair>& broadPhasePassedPairsOut );
+		FrameVector<BodyIdPair>& broadPhasePassedPairsOut );
 
 	bool checkCollidable( BodyId bodyIdA, BodyId bodyIdB )
 	{
-		const physicsBody& bodyA = m_bodies[bodyIdA];
-		const physicsBody& bodyB = m_bodies[bodyIdB];
-
-		if ( bodyA.getCollisionFilter() == bodyB.getCollisionFilter() )
+		if ( m_bodies.getCollisionFilter( bodyIdA ) == m_bodies.getCollisionFilter( bodyIdB ) )
 		{
 			return true;
 		}
@@ -51,8 +70,23 @@ public:
 		const std::vector<BodyIdPair>& cachedPairs,
 		const std::vector<BodyIdPair>& newPairs );
 
+	// Collide bucket of circle-circle pairs with the batched circle collider
+	void collideCircleBucket( FrameVector<NarrowphasePair>& narrowphasePairs,
+							  const FrameVector<int>& bucketedPairIdxs,
+							  const int bucketBegin, const int bucketEnd,
+							  FrameVector<ContactPoint>& contacts );
+
 	void solve();
 
+	// Give each simulated body a dense solver body index and store them in pairs
+	void prepareSolverBodies();
+
+	// Solve and integrate one island, called from pool threads
+	void solveIsland( int islandIdx, int threadIdx );
+
+	// Put island to sleep once all of its bodies have been slow for long enough
+	void updateIslandSleeping( const physicsIsland& island );
+
 	void updateJointConstraints();
 };
 
@@ -61,24 +95,39 @@ void physicsWorldEx::collide()
 	// Find new pairs in broadphase, delete caches for lost broadphase pairs
 
 	// Update broadphase AABB's
+	m_bodies.updateAabbs( m_activeBodyIds );
+
 	m_broadphaseBodies.clear(); // TODO: don't clear this, just overwrite the contents
 	for ( auto i = 0; i < m_activeBodyIds.size(); i++ )
 	{
 		int activeBodyId = m_activeBodyIds[i];
-		physicsBody& body = m_bodies[activeBodyId];
 
-		body.updateAabb(); // TODO: only update if aabb is dirty, don't update for static bodies
-
-		BroadphaseBody bpBody( body.getBodyId(), body.getAabb() );
+		BroadphaseBody bpBody( activeBodyId, m_bodies.getAabb( activeBodyId ) );
 		m_broadphaseBodies.push_back( bpBody ); // TODO: don't push_back this, just overwrite the contents
 	}
 
-	std::vector<BodyIdPair> bpPassedPairs;
+	FrameVector<BodyIdPair> bpPassedPairs( m_frameArena );
 	collideAabbs( m_broadphaseBodies, bpPassedPairs );
 
+	// Simulated bodies wake sleeping bodies they overlap
+	for ( int i = 0; i < ( int )bpPassedPairs.size(); i++ )
+	{
+		const BodyId bodyIdA = bpPassedPairs[i].bodyIdA;
+		const BodyId bodyIdB = bpPassedPairs[i].bodyIdB;
+
+		if ( m_bodies.isSimulated( bodyIdA ) && m_bodies.isSleeping( bodyIdB ) )
+		{
+			wakeIsland( bodyIdB, false );
+		}
+		else if ( m_bodies.isSimulated( bodyIdB ) && m_bodies.isSleeping( bodyIdA ) )
+		{
+			wakeIsland( bodyIdA, false );
+		}
+	}
+
 	std::sort( bpPassedPairs.begin(), bpPassedPairs.end(), bodyIdPairLess );
 	std::sort( m_existingPairs.begin(), m_existingPairs.end(), bodyIdPairLess );
-	std::vector<BodyIdPair> bpLostPairs, bpRemainedPairs;
+	FrameVector<BodyIdPair> bpLostPairs( m_frameArena ), bpRemainedPairs( m_frameArena );
 	BodyIdPairsUtils::classifyPairSets( m_existingPairs, bpPassedPairs, bpLostPairs, bpRemainedPairs, m_newPairs );
 
 	// Remove collision caches for which we lose broadphase pair
@@ -90,92 +139,104 @@ void physicsWorldEx::collide()
 	BodyIdPairsUtils::movePairsBtoA( m_existingPairs, m_newPairs );
 }
 
-struct aabbIndex
+void CachedPair::updateContacts( const ContactPoint* contacts, const int numNewContacts )
 {
-	int m_idx;
-	Vector4 m_part;
+	ManifoldPoint oldPoints[MAX_CONTACTS];
+	int numOldContacts = numContacts;
 
-	aabbIndex( int idx, const Vector4& part ) : m_idx( idx ), m_part( part ) {}
-};
+	for ( int i = 0; i < numOldContacts; i++ )
+	{
+		oldPoints[i] = points[i];
+	}
 
-static bool xless( const aabbIndex& aabbIdx1, const aabbIndex& aabbIdx2 )
-{
-	return aabbIdx1.m_part( 0 ) < aabbIdx2.m_part( 0 );
-}
+	numContacts = std::min( numNewContacts, MAX_CONTACTS );
 
-static bool yless( const aabbIndex& aabbIdx1, const aabbIndex& aabbIdx2 )
-{
-	return aabbIdx1.m_part( 1 ) < aabbIdx2.m_part( 1 );
+	for ( int i = 0; i < numContacts; i++ )
+	{
+		points[i].cp = contacts[i];
+		points[i].normalImp = 0.f;
+		points[i].tangentImp = 0.f;
+
+		unsigned int key = contacts[i].getFeatureKey();
+
+		for ( int j = 0; j < numOldContacts; j++ )
+		{
+			if ( oldPoints[j].cp.getFeatureKey() == key )
+			{
+				points[i].normalImp = oldPoints[j].normalImp;
+				points[i].tangentImp = oldPoints[j].tangentImp;
+				break;
+			}
+		}
+	}
 }
 
 void physicsWorldEx::collideAabbs( const std::vector<BroadphaseBody>& broadphaseBodies,
-								   std::vector<BodyIdPair>& broadPhasePassedPairsOut )
+								   FrameVector<BodyIdPair>& broadPhasePassedPairsOut )
 {
-	// Do 1D sweep & prune, add pairs which have overlapping AABB's
-	std::vector<aabbIndex> aabbIndices; // TODO: don't keep reconstructing this vector, store it and re-use
-
-	int numBpBodies = ( int )broadphaseBodies.size();
+	// Do 1D sweep & prune, aabbs sorted by min x can only overlap later aabbs starting before their max x
+	const int numBpBodies = ( int )broadphaseBodies.size();
 
+	FrameVector<int> order( numBpBodies, 0, m_frameArena );
 	for ( int i = 0; i < numBpBodies; i++ )
 	{
-		const BroadphaseBody& bpBody = broadphaseBodies[i];
-
-		aabbIndex idxMin( bpBody.bodyId, bpBody.aabb.m_min );
-		aabbIndex idxMax( bpBody.bodyId, bpBody.aabb.m_max );
-		aabbIndices.push_back( idxMin );
-		aabbIndices.push_back( idxMax );
+		order[i] = i;
 	}
 
-	std::sort( aabbIndices.begin(), aabbIndices.end(), xless );
+	const auto byMinX = [&broadphaseBodies]( int a, int b ) { return broadphaseBodies[a].aabb.m_min( 0 ) < broadphaseBodies[b].aabb.m_min( 0 ); };
+	std::sort( order.begin(), order.end(), byMinX );
 
-	std::vector<bool> flags( numBpBodies, false );
+	// Sorted aabbs as arrays for the sweep kernel, padded with aabbs which never overlap
+	const int numPadded = numBpBodies + physicsKernels::MAX_WIDTH;
+	FrameVector<Real> minX( numPadded, FLT_MAX, m_frameArena ), minY( numPadded, 0.f, m_frameArena );
+	FrameVector<Real> maxX( numPadded, -FLT_MAX, m_frameArena ), maxY( numPadded, 0.f, m_frameArena );
+	FrameVector<BodyId> bodyIds( numBpBodies, invalidId, m_frameArena );
 
-	for ( int i = 0; i < ( int )aabbIndices.size(); i++ )
+	for ( int i = 0; i < numBpBodies; i++ )
 	{
-		if ( aabbIndices[i].m_idx == -1 ) continue;
-
-		std::fill( flags.begin(), flags.end(), false );
-
-		for ( int j = i + 1; j < ( int )aabbIndices.size(); j++ )
-		{
-			if ( aabbIndices[j].m_idx == -1 ) continue;
-
-			if ( aabbIndices[i].m_idx == aabbIndices[j].m_idx )
-			{
-				aabbIndices[i].m_idx = -1;
-				aabbIndices[j].m_idx = -1;
-				break;
-			}
+		const BroadphaseBody& bpBody = broadphaseBodies[order[i]];
 
-			if ( flags[aabbIndices[j].m_idx] ) continue;
+		minX[i] = bpBody.aabb.m_min( 0 );
+		minY[i] = bpBody.aabb.m_min( 1 );
+		maxX[i] = bpBody.aabb.m_max( 0 );
+		maxY[i] = bpBody.aabb.m_max( 1 );
+		bodyIds[i] = bpBody.bodyId;
+	}
 
-			const physicsBody& bodyA = m_bodies[aabbIndices[i].m_idx];
-			const physicsBody& bodyB = m_bodies[aabbIndices[j].m_idx];
+	SweepAabbs aabbs;
+	aabbs.minX = minX.data();
+	aabbs.minY = minY.data();
+	aabbs.maxX = maxX.data();
+	aabbs.maxY = maxY.data();
+	aabbs.numAabbs = numBpBodies;
 
-			if ( bodyA.isStatic() && bodyB.isStatic() ) continue;
+	const physicsKernelTable& kernels = physicsKernels::get();
+	FrameVector<int> overlaps( numBpBodies, 0, m_frameArena );
 
-			if ( !checkCollidable( bodyA.getBodyId(), bodyB.getBodyId() ) ) continue;
+	for ( int i = 0; i < numBpBodies; i++ )
+	{
+		const int numOverlaps = kernels.findOverlaps( aabbs, i, overlaps.data() );
 
-			physicsAabb aabbA = bodyA.getAabb();
-			physicsAabb aabbB = bodyB.getAabb();
+		for ( int j = 0; j < numOverlaps; j++ )
+		{
+			const BodyId bodyIdA = bodyIds[i];
+			const BodyId bodyIdB = bodyIds[overlaps[j]];
 
-			if ( aabbA.overlaps( aabbB ) )
-			{
-				BodyIdPair pair( bodyA.getBodyId(), bodyB.getBodyId() );
+			if ( m_bodies.isStatic( bodyIdA ) && m_bodies.isStatic( bodyIdB ) ) continue;
 
-				broadPhasePassedPairsOut.push_back( pair );
+			if ( !checkCollidable( bodyIdA, bodyIdB ) ) continue;
 
-				flags[bodyB.getBodyId()] = true;
-			}
+			broadPhasePassedPairsOut.push_back( BodyIdPair( bodyIdA, bodyIdB ) );
 		}
 	}
 }
 
-void setAsContact( Constraint& constraint, const ContactPoint& contact, const Real rotA, const Real rotB )
+void setAsContact( Constraint& constraint, const ContactPoint& contact, const Rotation& rotA, const Rotation& rotB )
 {
 	constraint.rA = contact.getContactA();
 	constraint.rB = contact.getContactB();
 	constraint.error = contact.getDepth();
+	constraint.type = Constraint::CONTACT;
 
 	Vector4 norm = contact.getNormal(); norm.normalize<2>();
 	const Vector4& rA_ws = constraint.rA.getRotatedDir( rotA );
@@ -187,26 +248,65 @@ void setAsContact( Constraint& constraint, const ContactPoint& contact, const Re
 	constraint.jac.wB = rB_ws.cross( constraint.jac.vB );
 }
 
-void setAsFriction( Constraint& constraint, const ContactPoint& contact, const Real rotA, const Real rotB )
+void setAsFriction( Constraint& constraint, const ContactPoint& contact, const Rotation& rotA, const Rotation& rotB,
+					const Real friction, const int normalIdx )
 {
 	constraint.rA = contact.getContactA();
 	constraint.rB = contact.getContactB();
 	constraint.error = 0.f;
+	constraint.type = Constraint::FRICTION;
+	constraint.friction = friction;
+	constraint.normalIdx = normalIdx;
 
-	Transform tangential; tangential.setRotation( 90.f * g_degToRad );
-	Transform tA; tA.setRotation( rotA );
-	Transform tB; tB.setRotation( rotB );
+	// Quarter turn
+	const Rotation tangential( 0.f, 1.f );
 
 	Vector4 norm = contact.getNormal(); norm.normalize<2>();
-	Vector4 rA_ws; rA_ws.setTransformedPos( tA, constraint.rA );
-	Vector4 rB_ws; rB_ws.setTransformedPos( tB, constraint.rB );
+	Vector4 rA_ws; rA_ws.setRotatedDir( constraint.rA, rotA );
+	Vector4 rB_ws; rB_ws.setRotatedDir( constraint.rB, rotB );
 
-	constraint.jac.vA.setTransformedPos( tangential, norm.getNegated() );
+	constraint.jac.vA.setRotatedDir( norm.getNegated(), tangential );
 	constraint.jac.vB = constraint.jac.vA.getNegated();
 	constraint.jac.wA = rA_ws.cross( constraint.jac.vA );
 	constraint.jac.wB = rB_ws.cross( constraint.jac.vB );
 }
 
+void physicsWorldEx::collideCircleBucket( FrameVector<NarrowphasePair>& narrowphasePairs,
+										  const FrameVector<int>& bucketedPairIdxs,
+										  const int bucketBegin, const int bucketEnd,
+										  FrameVector<ContactPoint>& contacts )
+{
+	const int numPairs = bucketEnd - bucketBegin;
+
+	m_circlePairBatch.clear();
+
+	for ( int i = bucketBegin; i < bucketEnd; i++ )
+	{
+		const BodyIdPair& pair = narrowphasePairs[bucketedPairIdxs[i]].pair;
+		const physicsBody bodyA = m_bodies.getBody( pair.bodyIdA );
+		const physicsBody bodyB = m_bodies.getBody( pair.bodyIdB );
+
+		m_circlePairBatch.add( bodyA.getPosition(), bodyB.getPosition(),
+							   m_bodies.m_shapes.getTypedShape<physicsCircleShape>( bodyA.getShapeId() ).getRadius(),
+							   m_bodies.m_shapes.getTypedShape<physicsCircleShape>( bodyB.getShapeId() ).getRadius(),
+							   bodyA.getRotationCosSin(), bodyB.getRotationCosSin() );
+	}
+
+	// Contacts of i-th pair of bucket go to slot firstContact + i
+	const int firstContact = ( int )contacts.size();
+	contacts.resize( firstContact + numPairs );
+
+	FrameVector<int> numContacts( numPairs, 0, m_frameArena );
+	physicsCircleCollider::collideBatch( m_circlePairBatch, contacts.data() + firstContact, numContacts.data() );
+
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		NarrowphasePair& narrowphasePair = narrowphasePairs[bucketedPairIdxs[bucketBegin + i]];
+		narrowphasePair.firstContact = firstContact + i;
+		narrowphasePair.numContacts = numContacts[i];
+	}
+}
+
 void physicsWorldEx::mergeCollidableStreams( const std::vector<BodyIdPair>& existingPairs,
 											 const std::vector<BodyIdPair>& newPairs )
 {
@@ -214,7 +314,12 @@ void physicsWorldEx::mergeCollidableStreams( const std::vector<BodyIdPair>& exis
 	auto iterNew = newPairs.begin();
 	auto iterCached = m_cachedPairs.begin();
 
-	std::vector<CachedPair> pairsCachedThisFrame;
+	FrameVector<NarrowphasePair> narrowphasePairs( m_frameArena );
+	narrowphasePairs.reserve( existingPairs.size() + newPairs.size() );
+
+	// Number of pairs per pair of shape types
+	const int numBuckets = physicsShape::NUM_SHAPES * physicsShape::NUM_SHAPES;
+	int bucketOffsets[numBuckets + 1] = {};
 
 	while ( true )
 	{
@@ -254,79 +359,143 @@ void physicsWorldEx::mergeCollidableStreams( const std::vector<BodyIdPair>& exis
 			}
 		}
 
-		const physicsBody& bodyA = m_bodies[currentPair.bodyIdA];
-		const physicsBody& bodyB = m_bodies[currentPair.bodyIdB];
-		Transform transformA( bodyA.getPosition(), bodyA.getRotation() );
-		Transform transformB( bodyB.getPosition(), bodyB.getRotation() );
+		int cachedPairIdx = -1;
+
+		if ( iterCached != m_cachedPairs.end() && currentPair == *iterCached )
+		{
+			cachedPairIdx = ( int )( iterCached - m_cachedPairs.begin() );
+			iterCached++;
+		}
+
+		// Pairs with no simulated body keep their cache untouched until woken
+		if ( !m_bodies.isSimulated( currentPair.bodyIdA ) && !m_bodies.isSimulated( currentPair.bodyIdB ) )
+		{
+			continue;
+		}
+
+		NarrowphasePair narrowphasePair;
+		narrowphasePair.pair = currentPair;
+		narrowphasePair.cachedPairIdx = cachedPairIdx;
+		narrowphasePair.firstContact = 0;
+		narrowphasePair.numContacts = 0;
+		narrowphasePairs.push_back( narrowphasePair );
 
-		ColliderFuncPtr colliderFuncPtr = getCollisionFunc( bodyA, bodyB );
+		bucketOffsets[getShapePairBucket( currentPair ) + 1]++;
+	}
 
-		std::vector<ContactPoint> contacts;
-		colliderFuncPtr( bodyA.getShape(), bodyB.getShape(), transformA, transformB, contacts );
+	// Bucket pairs by their pair of shape types, so each collider runs over all of its pairs in one go
+	for ( int i = 0; i < numBuckets; i++ )
+	{
+		bucketOffsets[i + 1] += bucketOffsets[i];
+	}
 
-		bool canUseCache = false;
+	FrameVector<int> bucketedPairIdxs( narrowphasePairs.size(), 0, m_frameArena );
 
-		if ( iterCached != m_cachedPairs.end() )
+	{
+		int bucketEnds[numBuckets];
+		std::copy( bucketOffsets, bucketOffsets + numBuckets, bucketEnds );
+
+		for ( int i = 0; i < ( int )narrowphasePairs.size(); i++ )
 		{
-			if ( currentPair == *iterCached )
-			{
-				canUseCache = true;
+			bucketedPairIdxs[bucketEnds[getShapePairBucket( narrowphasePairs[i].pair )]++] = i;
+		}
+	}
 
-				// Clean up cache
-				
-			}
+	FrameVector<ContactPoint> contacts( m_frameArena );
+	contacts.reserve( narrowphasePairs.size() );
+
+	for ( int bucket = 0; bucket < numBuckets; bucket++ )
+	{
+		const int bucketBegin = bucketOffsets[bucket];
+		const int bucketEnd = bucketOffsets[bucket + 1];
+
+		if ( bucketBegin == bucketEnd )
+		{
+			continue;
 		}
 
-		if ( canUseCache )
+		if ( bucket == physicsShape::CIRCLE * physicsShape::NUM_SHAPES + physicsShape::CIRCLE )
 		{
-			if ( contacts.size() > 0 )
-			{
-				iterCached->addContact( contacts[0] );
+			collideCircleBucket( narrowphasePairs, bucketedPairIdxs, bucketBegin, bucketEnd, contacts );
+			continue;
+		}
 
-				// Add new contact constraint
-				ConstrainedPair constrainedPair( currentPair );
+		const ColliderFuncPtr colliderFuncPtr = m_dispatchTable[bucket / physicsShape::NUM_SHAPES][bucket % physicsShape::NUM_SHAPES];
 
-				constrainedPair.accumImp = iterCached->accumImp;  // re-use impulse
-				//drawText( std::to_string( constrainedPair.accumImp ), Vector3( 50.f, 50.f ) );
+		for ( int i = bucketBegin; i < bucketEnd; i++ )
+		{
+			NarrowphasePair& narrowphasePair = narrowphasePairs[bucketedPairIdxs[i]];
+			const physicsBody bodyA = m_bodies.getBody( narrowphasePair.pair.bodyIdA );
+			const physicsBody bodyB = m_bodies.getBody( narrowphasePair.pair.bodyIdB );
 
-				Constraint contactA;
-				//setAsContact( constraint0, iterCached->cpA, bodyA.getRotation(), bodyB.getRotation() );
-				setAsContact( contactA, contacts[0], bodyA.getRotation(), bodyB.getRotation() );
-				constrainedPair.constraints.push_back( contactA );
+			const Transform transformA = bodyA.getTransform();
+			const Transform transformB = bodyB.getTransform();
 
-				Constraint frictionA;
-				setAsFriction( frictionA, contacts[0], bodyA.getRotation(), bodyB.getRotation() );
-				constrainedPair.constraints.push_back( frictionA );
+			m_pairContacts.clear();
+			colliderFuncPtr( bodyA.getShape(), bodyB.getShape(), transformA, transformB, m_pairContacts );
 
-				if ( false )
-				//if ( iterCached->numContacts == 2 )
-				{
-					Constraint constraint1;
-					setAsContact( constraint1, iterCached->cpB, bodyA.getRotation(), bodyB.getRotation() );
-					constrainedPair.constraints.push_back( constraint1 );
-				}
+			narrowphasePair.firstContact = ( int )contacts.size();
+			narrowphasePair.numContacts = ( int )m_pairContacts.size();
+			contacts.insert( contacts.end(), m_pairContacts.begin(), m_pairContacts.end() );
+		}
+	}
 
-				m_contactSolvePairs.push_back( constrainedPair );
-			}
+	// Update caches and build constraints in pair order, which solver results depend on
+	FrameVector<CachedPair> pairsCachedThisFrame( m_frameArena );
 
-			iterCached++;
+	for ( auto iterPair = narrowphasePairs.begin(); iterPair != narrowphasePairs.end(); iterPair++ )
+	{
+		const BodyIdPair& currentPair = iterPair->pair;
+		CachedPair* cachedPair = ( iterPair->cachedPairIdx < 0 ) ? nullptr : &m_cachedPairs[iterPair->cachedPairIdx];
+
+		if ( cachedPair == nullptr && iterPair->numContacts > 0 )
+		{
+			pairsCachedThisFrame.push_back( CachedPair( currentPair ) );
+			cachedPair = &pairsCachedThisFrame.back();
 		}
-		else
+
+		if ( cachedPair == nullptr )
+		{
+			continue;
+		}
+
+		cachedPair->updateContacts( contacts.data() + iterPair->firstContact, iterPair->numContacts );
+
+		if ( cachedPair->numContacts > 0 )
 		{
-			if ( contacts.size() > 0 )
+			const physicsBody bodyA = m_bodies.getBody( currentPair.bodyIdA );
+			const physicsBody bodyB = m_bodies.getBody( currentPair.bodyIdB );
+
+			// Add contact and friction constraints for each manifold point
+			m_contactSolvePairs.push_back( ConstrainedPair( currentPair ) );
+			ConstrainedPair& constrainedPair = m_contactSolvePairs.back();
+
+			if ( !m_spareContactConstraints.empty() )
 			{
-				CachedPair cachedPair( currentPair );
-				cachedPair.addContact( contacts[0] );
-				pairsCachedThisFrame.push_back( cachedPair );
+				constrainedPair.constraints.swap( m_spareContactConstraints.back() );
+				m_spareContactConstraints.pop_back();
+			}
 
-				// Add new contact constraint
-				ConstrainedPair constrainedPair( currentPair );
+			// Room for any manifold, so recycled storage never grows
+			constrainedPair.constraints.reserve( 2 * CachedPair::MAX_CONTACTS );
 
-				Constraint constraint;
-				setAsContact( constraint, contacts[0], bodyA.getRotation(), bodyB.getRotation() );
-				constrainedPair.constraints.push_back( constraint );
+			const Real frictionCoeff = sqrt( bodyA.getFriction() * bodyB.getFriction() );
 
-				m_contactSolvePairs.push_back( constrainedPair );
+			for ( int i = 0; i < cachedPair->numContacts; i++ )
+			{
+				const ManifoldPoint& point = cachedPair->points[i];
+
+				// Re-use impulses of persisting points for warm starting
+				Constraint contact;
+				setAsContact( contact, point.cp, bodyA.getRotationCosSin(), bodyB.getRotationCosSin() );
+				contact.accumImp = point.normalImp;
+				constrainedPair.constraints.push_back( contact );
+
+				Constraint friction;
+				setAsFriction( friction, point.cp, bodyA.getRotationCosSin(), bodyB.getRotationCosSin(),
+							   frictionCoeff, ( int )constrainedPair.constraints.size() - 1 );
+				friction.accumImp = point.tangentImp;
+				constrainedPair.constraints.push_back( friction );
 			}
 		}
 	}
@@ -335,35 +504,140 @@ void physicsWorldEx::mergeCollidableStreams( const std::vector<BodyIdPair>& exis
 	std::sort( m_cachedPairs.begin(), m_cachedPairs.end(), bodyIdPairLess );
 }
 
-void physicsWorldEx::solve()
+// Swap constraints of island's pairs into island pairs, with solver body indices made local to island
+void gatherIslandPairs( const int firstSolverBodyIdx,
+						const int* pairIdxs,
+						const int numPairs,
+						std::vector<ConstrainedPair>& pairs,
+						std::vector<ConstrainedPair>& islandPairsOut )
 {
-	int numActiveBodies = ( int )m_activeBodyIds.size();
+	islandPairsOut.resize( numPairs );
 
-	m_solverBodies.resize( numActiveBodies );
+	// Island bodies follow the shared static body
+	auto toLocalIdx = [firstSolverBodyIdx]( int solverBodyIdx )
+	{
+		return ( solverBodyIdx == SolverBody::STATIC_BODY_IDX ) ? SolverBody::STATIC_BODY_IDX : solverBodyIdx - firstSolverBodyIdx + 1;
+	};
 
-	for ( int i = 0; i < numActiveBodies; i++ )
+	for ( int i = 0; i < numPairs; i++ )
 	{
-		int activeBodyId = m_activeBodyIds[i];
-		physicsBody& body = m_bodies[activeBodyId];
+		ConstrainedPair& pair = pairs[pairIdxs[i]];
+		ConstrainedPair& islandPair = islandPairsOut[i];
 
-		// Apply gravity
-		if ( !body.isStatic() )
+		islandPair.solverBodyIdxA = toLocalIdx( pair.solverBodyIdxA );
+		islandPair.solverBodyIdxB = toLocalIdx( pair.solverBodyIdxB );
+		islandPair.constraints.swap( pair.constraints );
+	}
+}
+
+// Swap constraints of pairs with a simulated body into simulated pairs, keeping their solver body indices
+// Pairs of sleeping and static bodies only, both at the shared static body, have nothing to solve
+void gatherSimulatedPairs( std::vector<ConstrainedPair>& pairs,
+						   std::vector<int>& pairIdxsOut,
+						   std::vector<ConstrainedPair>& simulatedPairsOut )
+{
+	pairIdxsOut.clear();
+
+	for ( int i = 0; i < ( int )pairs.size(); i++ )
+	{
+		if ( pairs[i].solverBodyIdxA != SolverBody::STATIC_BODY_IDX || pairs[i].solverBodyIdxB != SolverBody::STATIC_BODY_IDX )
 		{
-			const Vector4& currLinVel = body.getLinearVelocity();
-			body.setLinearVelocity( currLinVel + m_gravity * m_solverInfo.m_deltaTime );
+			pairIdxsOut.push_back( i );
 		}
+	}
+
+	simulatedPairsOut.resize( pairIdxsOut.size() );
 
-		// Prepare solver bodies
-		m_solverBodies[i].setFromBody( body );
+	for ( int i = 0; i < ( int )pairIdxsOut.size(); i++ )
+	{
+		ConstrainedPair& pair = pairs[pairIdxsOut[i]];
+		ConstrainedPair& simulatedPair = simulatedPairsOut[i];
+
+		simulatedPair.solverBodyIdxA = pair.solverBodyIdxA;
+		simulatedPair.solverBodyIdxB = pair.solverBodyIdxB;
+		simulatedPair.constraints.swap( pair.constraints );
+	}
+}
+
+void scatterIslandPairs( const int* pairIdxs,
+						 const int numPairs,
+						 std::vector<ConstrainedPair>& pairs,
+						 std::vector<ConstrainedPair>& islandPairs )
+{
+	for ( int i = 0; i < numPairs; i++ )
+	{
+		pairs[pairIdxs[i]].constraints.swap( islandPairs[i].constraints );
 	}
+}
 
+void physicsWorldEx::solve()
+{
 	updateJointConstraints();
 
-	// Solve constraints
-	m_solver->solveConstraints( m_solverInfo, true, m_contactSolvePairs, m_solverBodies );
-	m_solver->solveConstraints( m_solverInfo, false, m_jointSolvePairs, m_solverBodies );
+	// Joints to simulated bodies wake sleeping bodies
+	for ( auto iterJoint = m_jointSolvePairs.begin(); iterJoint != m_jointSolvePairs.end(); iterJoint++ )
+	{
+		if ( m_bodies.isSimulated( iterJoint->bodyIdA ) && m_bodies.isSleeping( iterJoint->bodyIdB ) )
+		{
+			wakeIsland( iterJoint->bodyIdB, false );
+		}
+		else if ( m_bodies.isSimulated( iterJoint->bodyIdB ) && m_bodies.isSleeping( iterJoint->bodyIdA ) )
+		{
+			wakeIsland( iterJoint->bodyIdA, false );
+		}
+	}
+
+	const bool useSubsteps = ( m_solverInfo.m_numSubsteps > 1 );
+
+	// Apply gravity, substeps apply it in the solver
+	if ( !useSubsteps )
+	{
+		m_bodies.applyGravity( m_activeBodyIds, m_gravity * m_solverInfo.m_deltaTime );
+	}
+
+	m_islandBuilder.buildIslands( m_bodies, m_activeBodyIds, m_contactSolvePairs, m_jointSolvePairs );
+
+	prepareSolverBodies();
+
+	const bool isWorldSolver = ( m_solverInfo.m_solverType == physicsSolverType::PARALLEL ||
+								 m_solverInfo.m_solverType == physicsSolverType::JACOBI );
+
+	if ( isWorldSolver && !useSubsteps )
+	{
+		// Graph colored and Jacobi solvers spread the whole world across threads
+		gatherSimulatedPairs( m_contactSolvePairs, m_simulatedContactPairIdxs, m_simulatedContactPairs );
+		gatherSimulatedPairs( m_jointSolvePairs, m_simulatedJointPairIdxs, m_simulatedJointPairs );
+
+		m_solver->solveConstraints( m_solverInfo, true, m_simulatedContactPairs, m_solverBodies );
+		m_solver->solveConstraints( m_solverInfo, false, m_simulatedJointPairs, m_solverBodies );
+
+		scatterIslandPairs( m_simulatedContactPairIdxs.data(), ( int )m_simulatedContactPairIdxs.size(),
+							m_contactSolvePairs, m_simulatedContactPairs );
+		scatterIslandPairs( m_simulatedJointPairIdxs.data(), ( int )m_simulatedJointPairIdxs.size(),
+							m_jointSolvePairs, m_simulatedJointPairs );
+
+		// Solver bodies are laid out island by island
+		for ( int i = 0; i < m_islandBuilder.getNumIslands(); i++ )
+		{
+			const physicsIsland island = m_islandBuilder.getIsland( i );
+			m_bodies.integrate( island.bodyIds, island.numBodies, &m_solverBodies[m_islandSolverBodyOffsets[i]],
+								m_solverInfo.m_deltaTime, false );
+			updateIslandSleeping( island );
+		}
+	}
+	else
+	{
+		// Islands share no simulated body, so each is solved and integrated on its own thread
+		// Substeps always go through islands
+		const auto solveIslandTask = [this]( int islandIdx, int threadIdx )
+		{
+			solveIsland( islandIdx, threadIdx );
+		};
+
+		m_threadPool->runTasks( m_islandBuilder.getNumIslands(), solveIslandTask );
+	}
 
-	// Store contact impulses
+	// Store contact impulses per manifold point
 	{
 		auto contactIter = m_contactSolvePairs.begin();
 		auto cacheIter = m_cachedPairs.begin();
@@ -372,7 +646,13 @@ void physicsWorldEx::solve()
 		{
 			if ( *contactIter == *cacheIter )
 			{
-				cacheIter->accumImp = contactIter->accumImp;
+				// Constraints are laid out as contact, friction per manifold point
+				for ( int i = 0; i < cacheIter->numContacts; i++ )
+				{
+					cacheIter->points[i].normalImp = contactIter->constraints[2 * i].accumImp;
+					cacheIter->points[i].tangentImp = contactIter->constraints[2 * i + 1].accumImp;
+				}
+
 				contactIter++;
 			}
 
@@ -380,74 +660,247 @@ void physicsWorldEx::solve()
 		}
 	}
 
+	// Store joint impulses for warm starting, pairs were built in pool order
+	{
+		int pairIdx = 0;
+
+		for ( int type = 0; type < ( int )physicsJointType::NUM_TYPES; type++ )
+		{
+			std::vector<physicsJoint>& joints = m_joints.getJoints( ( physicsJointType )type );
+
+			for ( auto iterJoint = joints.begin(); iterJoint != joints.end(); iterJoint++, pairIdx++ )
+			{
+				const std::vector<Constraint>& constraints = m_jointSolvePairs[pairIdx].constraints;
+
+				for ( int i = 0; i < ( int )constraints.size(); i++ )
+				{
+					iterJoint->accumImps[i] = constraints[i].accumImp;
+				}
+			}
+		}
+	}
+
+	// Keep constraint storage of contact pairs for next step's pairs
+	for ( auto iter = m_contactSolvePairs.begin(); iter != m_contactSolvePairs.end(); iter++ )
+	{
+		iter->constraints.clear();
+		m_spareContactConstraints.push_back( std::vector<Constraint>() );
+		m_spareContactConstraints.back().swap( iter->constraints );
+	}
+
 	m_contactSolvePairs.clear();
+}
 
-	// Update body velocities
-	for ( int activeBodyIdsIdx = 0; activeBodyIdsIdx < ( int ) m_solverBodies.size(); activeBodyIdsIdx++ )
+void assignSolverBodyIdxs( const std::vector<int>& bodySolverIdxs, std::vector<ConstrainedPair>& pairs )
+{
+	for ( auto iter = pairs.begin(); iter != pairs.end(); iter++ )
 	{
-		const SolverBody& solverBody = m_solverBodies[activeBodyIdsIdx];
-		physicsBody& body = m_bodies[activeBodyIdsIdx];
-		body.setFromSolverBody( solverBody );
+		iter->solverBodyIdxA = bodySolverIdxs[getBodyIdx( iter->bodyIdA )];
+		iter->solverBodyIdxB = bodySolverIdxs[getBodyIdx( iter->bodyIdB )];
 	}
+}
+
+void physicsWorldEx::prepareSolverBodies()
+{
+	const int numIslands = m_islandBuilder.getNumIslands();
+
+	m_bodySolverIdxs.assign( m_bodies.getNumSlots(), SolverBody::STATIC_BODY_IDX );
+	m_islandSolverBodyOffsets.resize( numIslands );
 
-	// Integrate time
-	for ( int i = 0; i < ( int )m_activeBodyIds.size(); i++ )
+	m_solverBodies.resize( 1 );
+	m_solverBodies[SolverBody::STATIC_BODY_IDX].setStatic();
+
+	// Only simulated bodies get a solver body of their own, laid out island by island
+	for ( int i = 0; i < numIslands; i++ )
 	{
-		int activeBodyId = m_activeBodyIds[i];
-		physicsBody& body = m_bodies[activeBodyId];
+		const physicsIsland island = m_islandBuilder.getIsland( i );
+		const int offset = ( int )m_solverBodies.size();
+		m_islandSolverBodyOffsets[i] = offset;
 
-		if ( !body.isStatic() )
+		for ( int j = 0; j < island.numBodies; j++ )
 		{
-			const Vector4& linVel = body.getLinearVelocity();
-			const Vector4& pos = body.getPosition();
-			body.setPosition( pos + linVel * m_solverInfo.m_deltaTime );
+			m_bodySolverIdxs[getBodyIdx( island.bodyIds[j] )] = offset + j;
+		}
+
+		m_solverBodies.resize( offset + island.numBodies );
+		m_bodies.getSolverBodies( island.bodyIds, island.numBodies, &m_solverBodies[offset] );
+	}
+
+	assignSolverBodyIdxs( m_bodySolverIdxs, m_contactSolvePairs );
+	assignSolverBodyIdxs( m_bodySolverIdxs, m_jointSolvePairs );
+}
+
+void physicsWorldEx::solveIsland( int islandIdx, int threadIdx )
+{
+	const physicsIsland island = m_islandBuilder.getIsland( islandIdx );
+	physicsIslandSolveContext& context = m_islandContexts[threadIdx];
 
-			const Real& w = body.getAngularSpeed();
-			const Real& rot = body.getRotation();
-			body.setRotation( rot + w * m_solverInfo.m_deltaTime );
+	const int firstSolverBodyIdx = m_islandSolverBodyOffsets[islandIdx];
+	const int numBodies = island.numBodies;
+
+	context.solverBodies.resize( numBodies + 1 );
+	context.solverBodies[SolverBody::STATIC_BODY_IDX] = m_solverBodies[SolverBody::STATIC_BODY_IDX];
+	std::copy( m_solverBodies.begin() + firstSolverBodyIdx,
+			   m_solverBodies.begin() + firstSolverBodyIdx + numBodies,
+			   context.solverBodies.begin() + 1 );
+
+	gatherIslandPairs( firstSolverBodyIdx, island.contactPairIdxs, island.numContactPairs, m_contactSolvePairs, context.contactPairs );
+	gatherIslandPairs( firstSolverBodyIdx, island.jointPairIdxs, island.numJointPairs, m_jointSolvePairs, context.jointPairs );
+
+	if ( m_solverInfo.m_numSubsteps > 1 )
+	{
+		context.solver->solveSubsteps( m_solverInfo, context.contactPairs, context.jointPairs, context.solverBodies );
+	}
+	else
+	{
+		context.solver->solveConstraints( m_solverInfo, true, context.contactPairs, context.solverBodies );
+
+		// Joints are solved after contacts, so a direct joint solve would undo contact impulses
+		if ( m_solverInfo.m_useDirectJointSolver && context.contactPairs.empty() )
+		{
+			context.solver->solveJointsDirect( m_solverInfo, context.jointPairs, context.solverBodies );
+		}
+		else
+		{
+			context.solver->solveConstraints( m_solverInfo, false, context.jointPairs, context.solverBodies );
 		}
 	}
+
+	scatterIslandPairs( island.contactPairIdxs, island.numContactPairs, m_contactSolvePairs, context.contactPairs );
+	scatterIslandPairs( island.jointPairIdxs, island.numJointPairs, m_jointSolvePairs, context.jointPairs );
+
+	m_bodies.integrate( island.bodyIds, numBodies, &context.solverBodies[1], m_solverInfo.m_deltaTime, m_solverInfo.m_numSubsteps > 1 );
+
+	updateIslandSleeping( island );
 }
 
-void physicsWorldEx::updateJointConstraints()
+void physicsWorldEx::updateIslandSleeping( const physicsIsland& island )
 {
-	for ( auto iterJoint = m_jointSolvePairs.begin(); iterJoint != m_jointSolvePairs.end(); iterJoint++ )
+	if ( !m_allowSleeping )
+	{
+		return;
+	}
+
+	const Real linearSleepSpeedSq = m_linearSleepSpeed * m_linearSleepSpeed;
+	bool canSleep = true;
+
+	for ( int i = 0; i < island.numBodies; i++ )
+	{
+		const BodyId bodyId = island.bodyIds[i];
+		const physicsBody body = m_bodies.getBody( bodyId );
+
+		if ( body.getLinearVelocity().lengthSquared<2>() > linearSleepSpeedSq ||
+			 fabs( body.getAngularSpeed() ) > m_angularSleepSpeed )
+		{
+			m_bodies.setSleepTime( bodyId, 0.f );
+		}
+		else
+		{
+			m_bodies.setSleepTime( bodyId, m_bodies.getSleepTime( bodyId ) + m_solverInfo.m_deltaTime );
+		}
+
+		canSleep &= ( m_bodies.getSleepTime( bodyId ) >= m_timeToSleep );
+	}
+
+	if ( !canSleep )
 	{
-		const physicsBody& bodyA = m_bodies[iterJoint->bodyIdA];
-		const physicsBody& bodyB = m_bodies[iterJoint->bodyIdB];
+		return;
+	}
+
+	// Link island bodies into a ring, waking any of them walks the ring
+	const int numBodies = island.numBodies;
+
+	for ( int i = 0; i < numBodies; i++ )
+	{
+		m_bodies.setSleeping( island.bodyIds[i], true );
+		m_bodies.setNextSleepingBodyId( island.bodyIds[i], island.bodyIds[( i + 1 ) % numBodies] );
+	}
+}
 
-		const Real rotA = bodyA.getRotation();
-		const Real rotB = bodyB.getRotation();
-		const Vector4& posA = bodyA.getPosition();
-		const Vector4& posB = bodyB.getPosition();
+// Row builders indexed by physicsJointType
+typedef void ( *JointConstraintsFunc )( const physicsJoint& joint,
+										const physicsBody& bodyA,
+										const physicsBody& bodyB,
+										const Real h,
+										std::vector<Constraint>& constraintsOut );
 
-		Constraint& constraintX = iterJoint->constraints[0];
-		const Vector4& rAworldx = constraintX.rA.getRotatedDir( rotA );
-		const Vector4& rBworldx = constraintX.rB.getRotatedDir( rotB );
+static const JointConstraintsFunc g_jointConstraintsFuncs[( int )physicsJointType::NUM_TYPES] =
+{
+	setRevoluteConstraints,
+	setDistanceConstraints,
+	setPrismaticConstraints,
+	setWeldConstraints
+};
+
+void physicsWorldEx::updateJointConstraints()
+{
+	// Pairs keep their constraint storage over steps
+	m_jointSolvePairs.resize( m_joints.getNumJoints() );
+
+	const Real h = m_solverInfo.m_deltaTime / std::max( m_solverInfo.m_numSubsteps, 1 );
+	int pairIdx = 0;
+
+	// Joints of a type are built in one run, leaving their rows next to each other for the solver
+	for ( int type = 0; type < ( int )physicsJointType::NUM_TYPES; type++ )
+	{
+		const std::vector<physicsJoint>& joints = m_joints.getJoints( ( physicsJointType )type );
+		const JointConstraintsFunc setConstraints = g_jointConstraintsFuncs[type];
 
-		constraintX.error = -( posA + rAworldx - posB - rBworldx )( 0 );
-		constraintX.jac.wA = rAworldx.cross( constraintX.jac.vA );
-		constraintX.jac.wB = rBworldx.cross( constraintX.jac.vB );
+		for ( auto iterJoint = joints.begin(); iterJoint != joints.end(); iterJoint++, pairIdx++ )
+		{
+			ConstrainedPair& pair = m_jointSolvePairs[pairIdx];
+			pair.set( iterJoint->bodyIdA, iterJoint->bodyIdB );
+			pair.constraints.clear();
 
-		Constraint& constraintY = iterJoint->constraints[1];
-		const Vector4& rAworldy = constraintY.rA.getRotatedDir( rotA );
-		const Vector4& rBworldy = constraintY.rB.getRotatedDir( rotB );
+			setConstraints( *iterJoint, m_bodies.getBody( iterJoint->bodyIdA ), m_bodies.getBody( iterJoint->bodyIdB ), h, pair.constraints );
 
-		constraintY.error = -( posA + rAworldy - posB - rBworldy )( 1 );
-		constraintY.jac.wA = rAworldy.cross( constraintY.jac.vA );
-		constraintY.jac.wB = rBworldy.cross( constraintY.jac.vB );
+			// Pair orders its ids, rows were built with joint's body A first
+			if ( pair.bodyIdA != iterJoint->bodyIdA )
+			{
+				for ( auto iterConstraint = pair.constraints.begin(); iterConstraint != pair.constraints.end(); iterConstraint++ )
+				{
+					std::swap( iterConstraint->rA, iterConstraint->rB );
+					std::swap( iterConstraint->jac.vA, iterConstraint->jac.vB );
+					std::swap( iterConstraint->jac.wA, iterConstraint->jac.wB );
+				}
+			}
+		}
 	}
 }
 
 physicsWorld::physicsWorld( const physicsWorldConfig& cinfo ) :
 	m_gravity( cinfo.m_gravity ),
 	m_cor( cinfo.m_cor ),
-	m_firstFreeBodyId( 0 )
+	m_allowSleeping( cinfo.m_allowSleeping ),
+	m_linearSleepSpeed( cinfo.m_linearSleepSpeed ),
+	m_angularSleepSpeed( cinfo.m_angularSleepSpeed ),
+	m_timeToSleep( cinfo.m_timeToSleep )
 {
-	m_solver = new physicsSolver;
+	m_threadPool = new physicsThreadPool( cinfo.m_numThreads );
+	m_solver = new physicsSolver( m_threadPool );
+
+	// Island solvers run inside pool tasks and solve serially
+	m_islandContexts.resize( m_threadPool->getNumThreads() );
+	for ( int i = 0; i < ( int )m_islandContexts.size(); i++ )
+	{
+		m_islandContexts[i].solver = new physicsSolver( nullptr );
+	}
 
 	m_solverInfo.m_deltaTime = cinfo.m_deltaTime;
 	m_solverInfo.m_numIter = cinfo.m_numIter;
+	m_solverInfo.m_minIter = cinfo.m_minIter;
+	m_solverInfo.m_velocityTolerance = cinfo.m_velocityTolerance;
+	m_solverInfo.m_numPositionIter = cinfo.m_numPositionIter;
+	m_solverInfo.m_useDirectJointSolver = cinfo.m_useDirectJointSolver;
+	m_solverInfo.m_contactBias = cinfo.m_contactBias;
+	m_solverInfo.m_jointBias = cinfo.m_jointBias;
+	m_solverInfo.m_solverType = cinfo.m_solverType;
+	m_solverInfo.m_numSubsteps = cinfo.m_numSubsteps;
+	m_solverInfo.m_gravity = cinfo.m_gravity;
+	m_solverInfo.m_contactHertz = cinfo.m_contactHertz;
+	m_solverInfo.m_contactDampingRatio = cinfo.m_contactDampingRatio;
+	m_solverInfo.m_jointHertz = cinfo.m_jointHertz;
+	m_solverInfo.m_jointDampingRatio = cinfo.m_jointDampingRatio;
 
 	physicsWorldEx* self = static_cast<physicsWorldEx*>( this );
 
@@ -457,133 +910,147 @@ physicsWorld::physicsWorld( const physicsWorldConfig& cinfo ) :
 	self->registerColliderFunc( physicsShape::BASE, physicsShape::CONVEX, nullptr );
 	self->registerColliderFunc( physicsShape::CIRCLE, physicsShape::CIRCLE, physicsCircleCollider::collide );
 	self->registerColliderFunc( physicsShape::CIRCLE, physicsShape::BOX, physicsCircleBoxCollider::collide );
-	self->registerColliderFunc( physicsShape::CIRCLE, physicsShape::CONVEX, physicsConvexCollider::collide );
+	self->registerConvexColliderFunc<physicsCircleShape, physicsConvexShape>( physicsShape::CIRCLE, physicsShape::CONVEX );
 	self->registerColliderFunc( physicsShape::BOX, physicsShape::BOX, physicsBoxCollider::collide );
-	self->registerColliderFunc( physicsShape::BOX, physicsShape::CONVEX, physicsConvexCollider::collide );
-	self->registerColliderFunc( physicsShape::CONVEX, physicsShape::CONVEX, physicsConvexCollider::collide );
+	self->registerConvexColliderFunc<physicsBoxShape, physicsConvexShape>( physicsShape::BOX, physicsShape::CONVEX );
+	self->registerConvexColliderFunc<physicsConvexShape, physicsConvexShape>( physicsShape::CONVEX, physicsShape::CONVEX );
 }
 
 physicsWorld::~physicsWorld()
 {
+	for ( int i = 0; i < ( int )m_islandContexts.size(); i++ )
+	{
+		delete m_islandContexts[i].solver;
+	}
+
 	delete m_solver;
+	delete m_threadPool;
 	m_bodies.clear();
 }
 
 BodyId physicsWorld::createBody( const physicsBodyCinfo& cinfo )
 {
-	if ( m_firstFreeBodyId < m_bodies.size() )
-	{
-		// Re-use previously allocated space for removed body
-		unsigned int freeId = m_firstFreeBodyId;
-		physicsBody& body = m_bodies[freeId];
-		FreeBody& freeBody = *reinterpret_cast<FreeBody*>( &body );
-		m_firstFreeBodyId = freeBody.m_nextFreeBodyIdx;
-		body = physicsBody( cinfo );
+	const BodyId bodyId = m_bodies.add( cinfo );
 
-		body.setBodyId( freeId );
-		m_activeBodyIds.push_back( body.getBodyId() );
-		body.setActiveListIdx( static_cast< int >( m_activeBodyIds.size() ) - 1 );
+	m_activeBodyIds.push_back( bodyId );
+	m_bodies.setActiveListIdx( bodyId, static_cast< int >( m_activeBodyIds.size() ) - 1 );
 
-		return body.getBodyId();
-	}
-	else
-	{
-		// Append on back
-		m_bodies.push_back( physicsBody( cinfo ) );
-		m_firstFreeBodyId = static_cast< BodyId >( m_bodies.size() );
-		physicsBody& body = m_bodies.back();
+	return bodyId;
+}
+
+void physicsWorld::createBodies( const std::vector<physicsBodyCinfo>& cinfos, std::vector<BodyId>& bodyIdsOut )
+{
+	const int firstNewIdx = ( int )bodyIdsOut.size();
+	m_bodies.add( cinfos, bodyIdsOut );
 
-		body.setBodyId( static_cast< int >( m_bodies.size() ) - 1 );
-		m_activeBodyIds.push_back( body.getBodyId() );
-		body.setActiveListIdx( static_cast< int >( m_activeBodyIds.size() ) - 1 );
+	// New bodies join the broadphase when it is next built from the active list
+	m_activeBodyIds.reserve( m_activeBodyIds.size() + cinfos.size() );
 
-		return body.getBodyId();
+	for ( int i = firstNewIdx; i < ( int )bodyIdsOut.size(); i++ )
+	{
+		m_activeBodyIds.push_back( bodyIdsOut[i] );
+		m_bodies.setActiveListIdx( bodyIdsOut[i], static_cast< int >( m_activeBodyIds.size() ) - 1 );
 	}
 }
 
 void physicsWorld::removeBody( const BodyId bodyId )
 {
-	// Body removed locations will be re-used for future body additions
-	physicsBody& body = m_bodies[bodyId];
+	if ( !m_bodies.isValid( bodyId ) )
+	{
+		Assert( false, "removing invalid body" );
+		return;
+	}
 
+	// Island of a removed sleeping body would keep a dangling ring
+	wakeIsland( bodyId, true );
 
+	// Joints would otherwise keep a stale handle, which reads whichever body re-uses the slot
+	m_joints.removeJointsOfBody( bodyId );
 
-	// Remove bodyId from actively simulated set
-	int activeListIdx = body.getActiveListIdx();
-	std::swap( m_activeBodyIds[activeListIdx], m_activeBodyIds.back() );
+	// Remove bodyId from actively simulated set, moving last active body into its place
+	int activeListIdx = m_bodies.getActiveListIdx( bodyId );
+	m_activeBodyIds[activeListIdx] = m_activeBodyIds.back();
+	m_bodies.setActiveListIdx( m_activeBodyIds[activeListIdx], activeListIdx );
 	m_activeBodyIds.pop_back();
 
-	// Add removed body's index to free body linked list
-	FreeBody& freeBody = *reinterpret_cast<FreeBody*>( &body );
-	freeBody.m_nextFreeBodyIdx = m_firstFreeBodyId;
-	m_firstFreeBodyId = body.getBodyId();
+	// Body removed locations will be re-used for future body additions
+	m_bodies.remove( bodyId );
 }
 
-int physicsWorld::addJoint( const JointConfig& config )
+void physicsWorld::removeBodies( const std::vector<BodyId>& bodyIds )
 {
-	ConstrainedPair joint( config.bodyIdA, config.bodyIdB );
+	for ( auto iter = bodyIds.begin(); iter != bodyIds.end(); iter++ )
 	{
-		const physicsBody& bodyA = m_bodies[joint.bodyIdA];
-		const physicsBody& bodyB = m_bodies[joint.bodyIdB];
-
-		Vector4 rAworld = config.pivot - bodyA.getPosition();
-		Vector4 rBworld = config.pivot - bodyB.getPosition();
-
-		Vector4 rAlocal = rAworld.getRotatedDir( -bodyA.getRotation() );
-		Vector4 rBlocal = rBworld.getRotatedDir( -bodyB.getRotation() );
-
-		// Constraint x-axis
-		{
-			Constraint constraintX;
-			constraintX.rA = rAlocal;
-			constraintX.rB = rBlocal;
-			constraintX.error = 0.f;
-			constraintX.jac.vA.set( 1.f, 0.f );
-			constraintX.jac.vB.set( -1.f, 0.f );
-			constraintX.jac.wA = constraintX.rA.cross( constraintX.jac.vA );
-			constraintX.jac.wB = constraintX.rB.cross( constraintX.jac.vB );
+		removeBody( *iter );
+	}
+}
 
-			joint.constraints.push_back( constraintX );
-		}
+JointId physicsWorld::addJoint( const JointConfig& config )
+{
+	Assert( m_bodies.isValid( config.bodyIdA ) && m_bodies.isValid( config.bodyIdB ), "joining invalid body" );
 
-		// Constraint y-axis
-		{
-			Constraint constraintY;
-			constraintY.rA = rAlocal;
-			constraintY.rB = rBlocal;
-			constraintY.error = 0.f;
-			constraintY.jac.vA.set( 0.f, 1.f );
-			constraintY.jac.vB.set( 0.f, -1.f );
-			constraintY.jac.wA = constraintY.rA.cross( constraintY.jac.vA );
-			constraintY.jac.wB = constraintY.rB.cross( constraintY.jac.vB );
+	wakeBody( config.bodyIdA );
+	wakeBody( config.bodyIdB );
 
-			joint.constraints.push_back( constraintY );
-		}
-	}
+	physicsJoint joint;
+	joint.setFromConfig( config, m_bodies.getBody( config.bodyIdA ), m_bodies.getBody( config.bodyIdB ) );
 
-	m_jointSolvePairs.push_back( joint );
-	return ( static_cast< int >( m_jointSolvePairs.size() ) - 1 );
+	return m_joints.add( config.type, joint );
 }
 
 void physicsWorld::removeJoint( JointId jointId )
 {
-	// TODO: think about what to do with this
-	auto jiter = m_jointSolvePairs.begin();
-	m_jointSolvePairs.erase( jiter + jointId );
+	if ( !m_joints.isValid( jointId ) )
+	{
+		Assert( false, "removing invalid joint" );
+		return;
+	}
+
+	const physicsJoint& joint = m_joints.get( jointId );
+	wakeBody( joint.bodyIdA );
+	wakeBody( joint.bodyIdB );
+
+	m_joints.remove( jointId );
 }
 
 void physicsWorld::step()
 {
+	m_frameArena.reset();
+
 	physicsWorldEx* self = static_cast<physicsWorldEx*>( this );
 	self->collide();
 	self->solve();
 }
 
+void physicsWorld::wakeBody( BodyId bodyId )
+{
+	wakeIsland( bodyId, true );
+	m_bodies.setSleepTime( bodyId, 0.f );
+}
+
+void physicsWorld::wakeIsland( BodyId bodyId, bool resetSleepTime )
+{
+	BodyId currBodyId = bodyId;
+
+	while ( currBodyId != invalidId && m_bodies.isSleeping( currBodyId ) )
+	{
+		const BodyId bodyId = currBodyId;
+		currBodyId = m_bodies.getNextSleepingBodyId( bodyId );
+		m_bodies.setSleeping( bodyId, false );
+
+		if ( resetSleepTime )
+		{
+			m_bodies.setSleepTime( bodyId, 0.f );
+		}
+	}
+}
+
 // TODO: prevent removed bodyId input
 void physicsWorld::setPosition( BodyId bodyId, const Vector4& point )
 {
-	physicsBody& body = m_bodies[bodyId];
-	body.setPosition( point );
+	wakeBody( bodyId );
+
+	m_bodies.setPosition( bodyId, point );
 }
 
 physicsMotionType physicsWorld::getMotionType( BodyId bodyId ) const
@@ -593,8 +1060,9 @@ physicsMotionType physicsWorld::getMotionType( BodyId bodyId ) const
 
 void physicsWorld::setMotionType( BodyId bodyId, physicsMotionType type )
 {
-	physicsBody& body = m_bodies[bodyId];
-	body.setMotionType( type );
+	wakeBody( bodyId );
+
+	m_bodies.setMotionType( bodyId, type );
 }
 
 //
@@ -607,11 +1075,11 @@ void physicsWorld::queryPoint( const Vector4& point, HitResult& hitResult ) cons
 
 	for ( auto i = 0; i < m_activeBodyIds.size(); i++ )
 	{
-		const physicsBody& body = getBody( m_activeBodyIds[i] );
+		const physicsBody body = getBody( m_activeBodyIds[i] );
 
 		Vector4 pointLocal;
 		pointLocal.setSub( point, body.getPosition() );
-		pointLocal.setRotatedDir( -body.getRotation() );
+		pointLocal.setInverseRotatedDir( pointLocal, body.getRotationCosSin() );
 		
 		if ( body.getShape()->containsPoint( pointLocal ) )
 		{
@@ -7,9 +7,13 @@
 #include <physicsShape.h> // For physicsShape::NUM_SHAPES
 #include <physicsCollider.h>
 #include <physicsSolver.h>
+#include <physicsJoint.h>
+#include <physicsIsland.h>
+#include <physicsFrameArena.h>
 
 struct ContactPoint;
 class physicsSolver;
+class physicsThreadPool;
 
 // Separate a lot of these typedefs, internally used structs to internal types header
 typedef void( *ColliderFuncPtr )( const physicsShape* shapeA, 
@@ -23,120 +27,85 @@ struct physicsWorldConfig
 	Vector4 m_gravity;
 	Real m_deltaTime;
 	Real m_cor;
-	int m_numIter;
+	int m_numIter;     // Most iterations per step
+	int m_minIter;
+	Real m_velocityTolerance; // Stop iterating once rows change velocity by less, zero always runs m_numIter
+	int m_numPositionIter; // Above zero, position error is corrected by split impulse instead of velocity bias
+	bool m_useDirectJointSolver; // Solve joint islands without contacts, limits or motors exactly instead of iterating
+	Real m_contactBias;
+	Real m_jointBias;
+	physicsSolverType m_solverType;
+	int m_numThreads; // Threads used by parallel work including calling thread, zero for all hardware threads
+	int m_numSubsteps; // Above one, steps are split into substeps of soft constraints, each running a single iteration
+	Real m_contactHertz;
+	Real m_contactDampingRatio;
+	Real m_jointHertz;
+	Real m_jointDampingRatio;
+	bool m_allowSleeping;
+	Real m_linearSleepSpeed;  // Islands with all bodies below both speeds for m_timeToSleep fall asleep
+	Real m_angularSleepSpeed; // Radians
+	Real m_timeToSleep;
 
 	physicsWorldConfig() :
 		m_gravity( 0.f, -98.1f ),
 		m_deltaTime( .016f ),
 		m_cor( 1.f ),
-		m_numIter( 8 ) {}
+		m_numIter( 4 ), // Warm starting carries impulses over steps, so few iterations suffice
+		m_minIter( 1 ),
+		m_velocityTolerance( 0.f ),
+		m_numPositionIter( 0 ),
+		m_useDirectJointSolver( false ),
+		m_contactBias( .2f ), // Contacts are warm started, full correction would re-apply the push
+		m_jointBias( 1.f ),
+		m_solverType( physicsSolverType::SEQUENTIAL ),
+		m_numThreads( 1 ),
+		m_numSubsteps( 1 ),
+		m_contactHertz( 30.f ),
+		m_contactDampingRatio( 10.f ),
+		m_jointHertz( 60.f ),
+		m_jointDampingRatio( 2.f ),
+		m_allowSleeping( true ),
+		m_linearSleepSpeed( 5.f ),
+		m_angularSleepSpeed( .5f ),
+		m_timeToSleep( .5f ) {}
 };
 
-struct JointConfig
+// Contact point kept over frames along with impulses applied to it
+struct ManifoldPoint
 {
-	int bodyIdA;
-	int bodyIdB;
-	Vector4 pivot;
+	ContactPoint cp;
+	Real normalImp;
+	Real tangentImp;
+
+	ManifoldPoint() : cp(), normalImp( 0.f ), tangentImp( 0.f ) {}
 };
 
 struct CachedPair : public BodyIdPair
 {
-	ContactPoint cpA;
-	ContactPoint cpB;
-	Real accumImp;
+	static const int MAX_CONTACTS = 2;
+
+	ManifoldPoint points[MAX_CONTACTS];
 	int numContacts;
-	int idx;
 
 public:
 
 	CachedPair( const BodyId a, const BodyId b ):
 		BodyIdPair( a, b ),
-		cpA(), cpB(), accumImp( 0.f ), numContacts( 0 ), idx( 0 )
+		numContacts( 0 )
 	{
 
 	}
 
 	CachedPair( const BodyIdPair& other ) :
 		BodyIdPair( other ),
-		cpA(), cpB(), accumImp( 0.f ), numContacts( 0 ), idx( 0 )
+		numContacts( 0 )
 	{
 
 	}
 
-	// TODO: move implementation out
-	void addContact(const ContactPoint& cp)
-	{
-/*
-		if ( idx == 0 )
-		{
-			cpA = cp;
-			numContacts = 1;
-		}
-		if ( idx == 1 )
-		{
-			cpB = cp;
-
-			if ( numContacts < 2 )
-			{
-				numContacts = 2;
-			}
-		}
-		idx = ( idx + 1 ) % 2;
-*/
-		if ( numContacts == 0 )
-		{
-			cpA = cp;
-			numContacts = 1;
-		}
-		else if ( numContacts == 1 )
-		{
-			Real distToA;
-			ContactPointUtils::getContactDifference( cp, cpA, distToA );
-			if ( distToA < 5.f )
-			{
-				cpA = cp;
-				numContacts = 1;
-			}
-			else
-			{
-				cpB = cp;
-				numContacts = 2;
-			}
-		}
-		else
-		{
-			Real distToA, distToB;
-			ContactPointUtils::getContactDifference( cp, cpA, distToA );
-			ContactPointUtils::getContactDifference( cp, cpB, distToB );
-
-			if ( distToA < 5.f )
-			{
-				cpA = cp;
-			}
-			else if ( distToB < 5.f )
-			{
-				cpB = cp;
-			}
-			else
-			{
-				cpA = cp;
-				numContacts = 1;
-			}
-		}
-	}
-/*	
-	ContactPoint getContact()
-	{
-		if ( idx == 0 )
-		{
-			return cpA;
-		}
-		if ( idx == 1 )
-		{
-			return cpB;
-		}
-	}
-*/
+	// Replace cached points with new contacts, new contacts with same
+	// feature pair as a cached point inherit its accumulated impulses
+	void updateContacts( const ContactPoint* contacts, const int numNewContacts );
 };
 
 struct BroadphaseBody
@@ -174,18 +143,31 @@ public:
 
 	BodyId createBody( const physicsBodyCinfo& cinfo );
 
+	// Create bodies in order of cinfos, appending their ids to bodyIdsOut
+	// Storage is reserved once and mass properties are calculated once per shape
+	void createBodies( const std::vector<physicsBodyCinfo>& cinfos, std::vector<BodyId>& bodyIdsOut );
+
+	// Joints attached to removed bodies are removed along with them, their ids become invalid
 	void removeBody( const BodyId bodyId );
 
+	void removeBodies( const std::vector<BodyId>& bodyIds );
+
 	const std::vector<BodyId>& getActiveBodyIds() const { return m_activeBodyIds; }
 
-	// TODO: add O(1) check which checks body is active
-	const physicsBody& getBody( const BodyId bodyId ) const { return m_bodies[bodyId]; }
+	// Removed bodies' ids are rejected, also after their slot is re-used
+	bool isValid( const BodyId bodyId ) const { return m_bodies.isValid( bodyId ); }
+
+	physicsBody getBody( const BodyId bodyId ) const { return m_bodies.getBody( bodyId ); }
 
-	int addJoint( const JointConfig& config );
+	// Returned id stays valid until the joint is removed
+	JointId addJoint( const JointConfig& config );
 
 	void removeJoint( JointId jointId );
 
 	void step();
+
+	// Wake body along with every body sleeping in the same island
+	void wakeBody( BodyId bodyId );
 	
 	// Utility funcs
 	void setPosition( BodyId bodyId, const Vector4& point );
@@ -197,6 +179,9 @@ public:
 
 	const std::vector<BroadphaseBody>& getBroadphaseBodies() const { return m_broadphaseBodies; }
 
+	// Backs buffers living within one step, physicsAllocationCounter shows whether steps still allocate
+	const physicsFrameArena& getFrameArena() const { return m_frameArena; }
+
 	// Spatial query
     // Return first body which occupies point
 	void queryPoint( const Vector4& point, HitResult& hitResult ) const;
@@ -206,13 +191,27 @@ protected:
 	Vector4 m_gravity;
 	Real m_cor;
 
-	// Array of bodies, both simulated and freed
-	std::vector<physicsBody> m_bodies;
+	bool m_allowSleeping;
+	Real m_linearSleepSpeed;
+	Real m_angularSleepSpeed;
+	Real m_timeToSleep;
+
+	// Wake island of a sleeping body, keeping sleep times lets an island woken by
+	// a touch fall back asleep unless it is joined by a moving island
+	void wakeIsland( BodyId bodyId, bool resetSleepTime );
+
+	// Bodies, both simulated and freed
+	physicsBodyStorage m_bodies;
 
     // Array of aabb's used for last step's broadphase
 	std::vector<struct BroadphaseBody> m_broadphaseBodies;
 	SolverInfo m_solverInfo;
 	physicsSolver* m_solver;
+	physicsThreadPool* m_threadPool;
+	physicsIslandBuilder m_islandBuilder;
+
+	// One per thread of m_threadPool, indexed by thread index
+	std::vector<physicsIslandSolveContext> m_islandContexts;
 	ColliderFuncPtr m_dispatchTable[physicsShape::NUM_SHAPES][physicsShape::NUM_SHAPES];
 
 	// New broadphase pairs
@@ -222,12 +221,39 @@ protected:
 	std::vector<BodyIdPair> m_existingPairs;
 
 	std::vector<CachedPair> m_cachedPairs;
+	physicsJointPool m_joints;
+
+	// Rows of every joint, rebuilt each step in pool order
 	std::vector<ConstrainedPair> m_jointSolvePairs;
 	std::vector<ConstrainedPair> m_contactSolvePairs;
 
+	// Pairs with a simulated body and their indices in the pairs above, solved by world solvers
+	std::vector<ConstrainedPair> m_simulatedContactPairs;
+	std::vector<ConstrainedPair> m_simulatedJointPairs;
+	std::vector<int> m_simulatedContactPairIdxs;
+	std::vector<int> m_simulatedJointPairIdxs;
+
+	// Constraint storage of last step's contact pairs, handed to this step's pairs
+	std::vector<std::vector<Constraint>> m_spareContactConstraints;
+
+	// Contacts of the pair being collided by a per-pair collider
+	std::vector<ContactPoint> m_pairContacts;
+
+	// Circle-circle pairs of this step, kept to reuse its storage
+	CirclePairBatch m_circlePairBatch;
+
+	// Reset at the start of each step
+	physicsFrameArena m_frameArena;
+
 	// Array of body Ids for which body is simulated
 	std::vector<BodyId> m_activeBodyIds;
 
+	// Shared static body followed by simulated bodies grouped by island, rebuilt each step
 	std::vector<SolverBody> m_solverBodies;
-	BodyId m_firstFreeBodyId;
+
+	// Index into m_solverBodies for each body slot index, static and sleeping bodies map to the shared static body
+	std::vector<int> m_bodySolverIdxs;
+
+	// First solver body of each island
+	std::vector<int> m_islandSolverBodyOffsets;
 };